@@ -149,6 +149,34 @@ export class CppEngineBridge extends EventEmitter {
     return this.sendCommand('get_stats');
   }
   
+  // query: { where: [{ field, op, value }], sort, order, limit }
+  async screen(query) {
+    return this.sendCommand('screen', query);
+  }
+  
+  // Alert journal: enter/update/exit events in [from, to] (ms since epoch)
+  async queryAlerts({ from = 0, to = Date.now(), symbol = '', limit = 1000 } = {}) {
+    return this.sendCommand('query_journal', { from, to, symbol, limit });
+  }
+  
+  // Compressed tick history for one symbol; summary=true returns only
+  // count/first/last/min/max/volume over the window
+  async getHistory(symbol, { from = 0, to = Date.now(), summary = false } = {}) {
+    return this.sendCommand('get_history', { symbol, from, to, summary });
+  }
+  
+  // Flight recorder: write a dump of every thread's recent hot-path
+  // events now; resolves with { path }
+  async dumpTrace() {
+    return this.sendCommand('dump_trace', {});
+  }
+  
+  // Partitioned deployments (stock_monitor_aggregator only): instances,
+  // connection state and symbols owned by each
+  async getCluster() {
+    return this.sendCommand('get_cluster', {});
+  }
+  
   async subscribe(symbols) {
     return this.sendCommand('subscribe', { symbols });
   }
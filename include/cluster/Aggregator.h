@@ -0,0 +1,116 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <functional>
+#include <cstdint>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <nlohmann/json.hpp>
+#include "cluster/HashRing.h"
+
+namespace stock_monitor {
+
+struct EngineEndpoint {
+    std::string id;    // Ring node name; must match the engine's --partition-id
+    std::string host;
+    uint16_t port;
+
+    // "id=host:port" or "host:port" (id defaults to "host:port");
+    // throws std::invalid_argument
+    static EngineEndpoint parse(const std::string& spec);
+};
+
+// Front for a partitioned deployment. Each engine instance owns the
+// consistent-hash slice of the universe for its id; the aggregator
+// speaks the engine bridge protocol (newline-delimited JSON) to
+// CppEngineBridge and:
+//   - fans read commands out and merges leaderboards, stats, screens
+//     and journal queries; per-symbol commands go to the owner only
+//   - forwards alert/update pushes from each symbol's owner, so the old
+//     owner's leftovers (and symbols outside the universe) are dropped;
+//     their market context is tagged as partition-local
+//   - rebalances when an instance stays down for failover_ms or comes
+//     back, by sending subscribe/unsubscribe for the moved symbols
+//   - reconciles each instance on (re)connect: whatever it missed while
+//     down is unsubscribed, then its owned slice is resubscribed
+// All state lives on one io_context thread; no locks.
+class Aggregator {
+public:
+    struct Config {
+        uint16_t port = 8080;
+        std::vector<EngineEndpoint> engines;
+        std::vector<std::string> symbols;
+        uint64_t reconnect_ms = 1000;
+        uint64_t failover_ms = 3000;        // Grace before a lost instance's symbols move
+        uint64_t request_timeout_ms = 2000; // Fan-outs reply with what arrived by then
+        uint64_t stats_interval_ms = 1000;  // Merged stats push period
+    };
+
+    Aggregator(boost::asio::io_context& io, const Config& config);
+    ~Aggregator();
+
+    Aggregator(const Aggregator&) = delete;
+    Aggregator& operator=(const Aggregator&) = delete;
+
+    // Binds the port and starts connecting; throws on bind failure
+    void start();
+    void stop();
+
+private:
+    class EngineLink;
+    class ClientSession;
+    struct FanOut;
+
+    using Reply = std::function<void(nlohmann::json)>;
+    using Results = std::vector<std::pair<std::string, nlohmann::json>>;  // (node, data)
+    using Merge = std::function<nlohmann::json(Results&)>;
+
+    // Engine link events
+    void on_link_up(EngineLink& link);
+    void on_link_down(EngineLink& link);
+    void on_push(EngineLink& link, const nlohmann::json& message, const std::string& line);
+
+    // Client requests; throws on malformed input (answered with an error)
+    void handle_request(const std::shared_ptr<ClientSession>& session,
+                        const nlohmann::json& request);
+    void fan_out(const std::vector<EngineLink*>& targets, const std::string& command,
+                 const nlohmann::json& data, Merge merge, Reply reply);
+    void route(const std::string& symbol, const std::string& command,
+               const nlohmann::json& data, Reply reply);
+    size_t change_universe(const std::vector<std::string>& symbols, bool add);  // Returns symbols changed
+    nlohmann::json merge_stats(Results& results) const;
+
+    void rebalance(const std::string& reconciling = "");
+    void reconcile(const std::string& node);
+    void send_subscriptions(const std::string& node, const char* command,
+                            const std::vector<std::string>& symbols);
+    bool owns(const std::string& node, const std::string& symbol) const;
+    EngineLink* link_for(const std::string& node) const;
+    std::vector<EngineLink*> connected_links() const;
+    nlohmann::json cluster_state() const;
+
+    void accept();
+    void schedule_stats();
+    void broadcast(const std::string& line);
+
+    boost::asio::io_context& io_;
+    Config config_;
+    boost::asio::ip::tcp::acceptor acceptor_;
+    boost::asio::steady_timer stats_timer_;
+
+    std::vector<std::shared_ptr<EngineLink>> links_;
+    std::unordered_set<std::shared_ptr<ClientSession>> sessions_;
+
+    HashRing ring_;
+    std::vector<std::string> universe_;                    // Subscription order
+    std::unordered_map<std::string, std::string> owner_;   // symbol -> node ("" = none)
+    std::unordered_set<std::string> retired_;              // Removed from the universe
+    bool running_ = false;
+};
+
+} // namespace stock_monitor
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+namespace stock_monitor {
+
+// Virtual nodes per instance; engines and the aggregator must agree
+constexpr size_t kDefaultVirtualNodes = 128;
+
+// Consistent-hash ring mapping symbols to engine instances. The hash is
+// fixed (FNV-1a + splitmix64 finalizer), not std::hash, so every process
+// computes the same slices. Adding or removing one of N instances moves
+// about 1/N of the symbols.
+class HashRing {
+public:
+    explicit HashRing(size_t virtual_nodes = kDefaultVirtualNodes);
+
+    void add_node(const std::string& node);
+    void remove_node(const std::string& node);
+    bool contains(const std::string& node) const;
+    const std::vector<std::string>& nodes() const { return nodes_; }
+    bool empty() const { return nodes_.empty(); }
+
+    // Empty string when the ring has no nodes
+    const std::string& owner(std::string_view key) const;
+
+    // Keys (in input order) that `node` owns
+    std::vector<std::string> slice(const std::string& node,
+                                   const std::vector<std::string>& keys) const;
+
+    static uint64_t hash(std::string_view key);
+
+private:
+    void rebuild();
+
+    size_t virtual_nodes_;
+    std::vector<std::string> nodes_;                  // Sorted
+    std::vector<std::pair<uint64_t, uint32_t>> points_;  // (hash, node index), sorted
+};
+
+// Universe file: one symbol per line; blank lines and '#' comments are
+// skipped. Throws std::runtime_error if the file cannot be read.
+std::vector<std::string> load_symbol_list(const std::string& path);
+
+} // namespace stock_monitor
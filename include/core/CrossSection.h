@@ -0,0 +1,121 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include <nlohmann/json_fwd.hpp>
+
+namespace stock_monitor {
+
+// Symbol -> sector / index membership, loaded from a local CSV file:
+//   # symbol,sector[,index]
+//   AAPL,Technology,NDX
+//   XOM,Energy,SPX
+class SectorMap {
+public:
+    static SectorMap load(const std::string& path);
+
+    int32_t sector_id(const std::string& symbol) const;
+    int32_t index_id(const std::string& symbol) const;
+
+    const std::string& sector_name(int32_t id) const;
+    const std::string& index_name(int32_t id) const;
+    size_t sector_count() const { return sectors_.size(); }
+    size_t index_count() const { return indexes_.size(); }
+    bool empty() const { return entries_.empty(); }
+
+private:
+    struct Entry {
+        int32_t sector;
+        int32_t index;
+    };
+
+    static int32_t intern(std::vector<std::string>& names, const std::string& name);
+
+    std::unordered_map<std::string, Entry> entries_;
+    std::vector<std::string> sectors_;
+    std::vector<std::string> indexes_;
+};
+
+// Columnar snapshot of per-symbol window state, one row per symbol.
+// Group ids are -1 for symbols missing from the sector map.
+struct CrossSectionColumns {
+    std::vector<double> current;
+    std::vector<double> min;
+    std::vector<double> max;
+    std::vector<double> open;
+    std::vector<int32_t> sector_id;
+    std::vector<int32_t> index_id;
+
+    size_t size() const { return current.size(); }
+    void clear();
+    void reserve(size_t n);
+};
+
+struct GroupAggregate {
+    std::string name;
+    uint32_t count = 0;
+    uint32_t advancing = 0;
+    double avg_change = 0.0;
+    double stddev_change = 0.0;
+};
+
+void to_json(nlohmann::json& j, const GroupAggregate& group);
+
+struct CrossSectionResult {
+    uint64_t timestamp = 0;
+    uint64_t compute_time_ns = 0;
+
+    // Market breadth (advancing = current above window open)
+    size_t symbols = 0;
+    size_t advancing = 0;
+    double advancing_pct = 0.0;
+    double avg_change = 0.0;
+    double stddev_change = 0.0;
+
+    std::vector<GroupAggregate> sectors;
+    std::vector<GroupAggregate> indexes;
+
+    // Per-row columns, aligned with the snapshot rows
+    std::vector<double> change;
+    std::vector<int32_t> sector_id;
+    std::vector<int32_t> index_id;
+
+    // Z-score moments by sector id + 1, for grouped_zscores_avx2; slot 0
+    // is market-wide for unmapped symbols. A zero inverse stddev gives z 0.
+    std::vector<double> zscore_means;
+    std::vector<double> zscore_inv_stddevs;
+};
+
+// Cross-sectional context attached to an alert
+struct MarketContext {
+    std::string sector;
+    double advancing_pct = 0.0;
+    double sector_avg_change = 0.0;
+    double sector_zscore = 0.0;
+    double market_zscore = 0.0;
+    uint32_t sector_rank = 0;   // 1 = strongest; 0 = not available
+    uint32_t sector_size = 0;
+    uint32_t index_rank = 0;    // Rank in the index, or market-wide if unmapped
+    uint32_t index_size = 0;
+};
+
+void to_json(nlohmann::json& j, const MarketContext& context);
+
+class CrossSectionCalculator {
+public:
+    // Compute breadth, group aggregates and z-scores for one snapshot
+    static void compute(const CrossSectionColumns& columns,
+                        const SectorMap& sector_map,
+                        CrossSectionResult& out);
+
+    // Context for a symbol whose live change may be newer than the snapshot
+    static MarketContext context_for(const CrossSectionResult& result,
+                                     const SectorMap& sector_map,
+                                     double change_percent,
+                                     int32_t sector_id,
+                                     int32_t index_id);
+};
+
+} // namespace stock_monitor
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include "PriceData.h"
+
+namespace stock_monitor {
+
+// Symbol-sharded ingest queue between the feed decoder and StockMonitor.
+// Each shard thread drains its whole queue per pass and measures lag as
+// the age of the oldest drained message. Above conflate_lag_us the batch
+// is conflated per symbol: trades and quote mids each collapse to their
+// low, high and last, so the price window's min/max stay exact. Above
+// shed_lag_us, updates are ranked by how far their price sits below the
+// symbol's entry price (where it would enter the threshold band): those
+// within shed_keep_pct are kept, and that margin narrows as lag grows, so
+// the symbols furthest from alerting go first. Prints at or above the
+// entry price are never shed. A shed update still competes for its
+// symbol's low and a shed trade's volume rides on the symbol's emitted
+// print, so only highs and interior prices are lost.
+class IngestPipeline {
+public:
+    struct Config {
+        size_t shards = 1;
+        uint64_t conflate_lag_us = 2000;
+        uint64_t shed_lag_us = 20000;
+        double shed_keep_pct = 3.0;  // Margin below entry kept at shed_lag_us
+        uint64_t priority_refresh_ms = 500;
+    };
+
+    // When an update entered the engine: TSC for trace events, steady
+    // clock for latency, so queue wait counts toward both
+    struct Arrival {
+        uint64_t tsc;
+        uint64_t steady_ns;
+
+        static Arrival now();
+    };
+
+    // spread_percent < 0 marks a trade, otherwise a quote mid
+    using Sink = std::function<void(const TradeData&, double spread_percent,
+                                    const Arrival& arrival)>;
+    
+    // Price at which the symbol would enter the threshold band; 0 keeps
+    // every update (unknown symbols, or ones already in the band whose
+    // exits must be seen)
+    using EntryPriceFn = std::function<double(const std::string& symbol)>;
+
+    struct Stats {
+        uint64_t received;
+        uint64_t processed;
+        uint64_t conflated;
+        uint64_t shed;
+        uint64_t queue_depth;
+        double lag_us;       // Lag of the most recent drain, worst shard
+        double max_lag_us;   // Since last get_stats()
+        bool overloaded;
+    };
+
+    IngestPipeline(const Config& config, Sink sink, EntryPriceFn entry_price);
+    ~IngestPipeline();
+
+    IngestPipeline(const IngestPipeline&) = delete;
+    IngestPipeline& operator=(const IngestPipeline&) = delete;
+
+    void submit(const TradeData& trade, double spread_percent);
+
+    Stats get_stats() const;
+
+private:
+    struct Message {
+        TradeData trade;
+        double spread_percent;
+        Arrival arrival;
+    };
+
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::deque<Message> queue;
+        std::atomic<uint64_t> depth{0};
+        std::atomic<uint64_t> lag_ns{0};
+        std::thread thread;
+    };
+
+    // Per-thread conflation state, allocated on the shard's own thread
+    struct ShardScratch;
+
+    void run_shard(Shard& shard);
+    void process_batch(std::vector<Message>& batch, uint64_t lag_ns, ShardScratch& scratch);
+
+    Config config_;
+    Sink sink_;
+    EntryPriceFn entry_price_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<bool> running_{true};
+
+    std::atomic<uint64_t> received_{0};
+    std::atomic<uint64_t> processed_{0};
+    std::atomic<uint64_t> conflated_{0};
+    std::atomic<uint64_t> shed_{0};
+    mutable std::atomic<uint64_t> max_lag_ns_{0};
+};
+
+} // namespace stock_monitor
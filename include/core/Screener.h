@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <shared_mutex>
+#include <nlohmann/json_fwd.hpp>
+
+namespace stock_monitor {
+
+enum class ScreenField : uint8_t {
+    Price,
+    Change,   // % above window low, same as the alert threshold
+    Volume,   // Session trade volume
+    Spread,   // Last quoted spread, % of mid; -1 before the first quote
+    Min,
+    Max,
+    ZScore    // Change z-score within its sector (market-wide if unmapped)
+};
+constexpr size_t kScreenFieldCount = 7;
+
+enum class ScreenOp : uint8_t {
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+    Between   // value <= x <= upper
+};
+
+struct ScreenPredicate {
+    ScreenField field;
+    ScreenOp op;
+    double value;
+    double upper = 0.0;
+};
+
+// Predicates are ANDed. Bridge form:
+//   {"where": [{"field": "price", "op": "between", "value": [1, 20]},
+//              {"field": "volume", "op": ">", "value": 1000000}],
+//    "sort": "change", "order": "desc", "limit": 50}
+struct ScreenQuery {
+    std::vector<ScreenPredicate> predicates;
+    ScreenField sort_field = ScreenField::Change;
+    bool descending = true;
+    size_t limit = 100;
+
+    // Throws std::invalid_argument on unknown fields or operators
+    static ScreenQuery from_json(const nlohmann::json& j);
+};
+
+struct ScreenRow {
+    std::string symbol;
+    std::array<double, kScreenFieldCount> values;
+};
+
+struct ScreenResult {
+    std::vector<ScreenRow> rows;
+    size_t matched = 0;
+    size_t scanned = 0;
+    uint64_t snapshot_timestamp = 0;
+    uint64_t query_time_ns = 0;
+};
+
+void to_json(nlohmann::json& j, const ScreenResult& result);
+
+// Immutable columnar mirror of per-symbol state, one row per symbol
+struct ScreenerSnapshot {
+    uint64_t timestamp = 0;
+    std::vector<std::string> symbols;
+    std::array<std::vector<double>, kScreenFieldCount> columns;
+
+    const std::vector<double>& column(ScreenField field) const {
+        return columns[static_cast<size_t>(field)];
+    }
+    std::vector<double>& column(ScreenField field) {
+        return columns[static_cast<size_t>(field)];
+    }
+};
+
+// Evaluates queries against the latest published snapshot. Readers only
+// copy a shared_ptr, so queries never contend with the ingest path.
+class Screener {
+public:
+    void publish(std::shared_ptr<const ScreenerSnapshot> snapshot);
+    std::shared_ptr<const ScreenerSnapshot> snapshot() const;
+
+    ScreenResult run(const ScreenQuery& query) const;
+
+    // AND the predicate's match bits into `mask` (one bit per row)
+    static void filter_avx2(const double* values,
+                            size_t count,
+                            const ScreenPredicate& predicate,
+                            uint64_t* mask);
+
+private:
+    mutable std::shared_mutex mutex_;
+    std::shared_ptr<const ScreenerSnapshot> snapshot_;
+};
+
+} // namespace stock_monitor
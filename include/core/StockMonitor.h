@@ -2,12 +2,23 @@
 
 #include <atomic>
 #include <unordered_map>
+#include <unordered_set>
 #include <shared_mutex>
+#include <mutex>
 #include <memory>
 #include <vector>
+#include <thread>
+#include <functional>
+#include <optional>
 #include <immintrin.h> // For AVX2
+#include <nlohmann/json_fwd.hpp>
 #include "CircularBuffer.h"
 #include "PriceData.h"
+#include "CrossSection.h"
+#include "Screener.h"
+#include "IngestPipeline.h"
+#include "storage/AlertJournal.h"
+#include "storage/TickHistory.h"
 
 namespace stock_monitor {
 
@@ -19,6 +30,26 @@ public:
         double threshold_max = 13.0;
         size_t max_stocks = 10000;
         size_t cleanup_interval_ms = 60000;
+        std::string sector_map_path;  // Empty = market-wide breadth only
+        size_t cross_section_interval_ms = 1000;
+        size_t screener_refresh_ms = 100;
+        
+        // 0 = process on the caller's thread; otherwise queue per symbol
+        // shard with conflation/shedding under lag (see IngestPipeline)
+        size_t ingest_shards = 0;
+        uint64_t conflate_lag_us = 2000;
+        uint64_t shed_lag_us = 20000;
+        double shed_keep_pct = 3.0;
+        
+        std::string journal_dir;  // Empty = no alert journal
+        size_t journal_retention_days = 30;
+        
+        // Compressed per-symbol tick history beyond the live window
+        bool history_enabled = false;
+        size_t history_max_blocks = 0;  // Per symbol, 1 KB each; 0 = unbounded
+        
+        // An update slower than this asks the flight recorder for a dump (0 = off)
+        uint64_t trace_trigger_us = 0;
     };
 
     struct AlertData {
@@ -30,12 +61,13 @@ public:
         uint64_t volume;
         uint64_t timestamp;
         std::string webull_url;
+        MarketContext context;
     };
 
     explicit StockMonitor(const Config& config);
     ~StockMonitor();
 
-    // Process incoming price update (thread-safe)
+    // Process incoming price update (thread-safe; queued when ingest_shards > 0)
     void process_trade(const TradeData& trade);
     void process_quote(const QuoteData& quote);
     
@@ -52,13 +84,65 @@ public:
         size_t updates_per_second;
         double avg_processing_time_us;
         size_t memory_usage_bytes;
+        
+        // Compressed tick history (zero when disabled)
+        size_t history_ticks;
+        size_t history_bytes;
+        
+        // Latest cross-sectional snapshot
+        double advancing_pct;
+        double avg_change;
+        double cross_section_time_us;
+        std::vector<GroupAggregate> sectors;
+        
+        // Ingest queue (zero when processing synchronously)
+        uint64_t conflated_updates;
+        uint64_t shed_updates;
+        uint64_t queue_depth;
+        double ingest_lag_us;
+        double max_ingest_lag_us;
+        bool overloaded;
     };
     Stats get_stats() const;
+    
+    // Latest cross-sectional snapshot (null until the first pass runs)
+    std::shared_ptr<const CrossSectionResult> get_cross_section() const;
+    
+    // Alert enter/update/exit history, oldest first (empty without a journal)
+    std::vector<JournalRecord> query_journal(uint64_t from_ms,
+                                             uint64_t to_ms,
+                                             const std::string& symbol,
+                                             size_t limit) const;
+    
+    // Tick history in [from_ms, to_ms] (empty/nullopt without history)
+    std::optional<TickHistory::Summary> get_history_summary(const std::string& symbol,
+                                                            uint64_t from_ms,
+                                                            uint64_t to_ms) const;
+    std::vector<PricePoint> get_history(const std::string& symbol,
+                                        uint64_t from_ms,
+                                        uint64_t to_ms) const;
+    
+    // Ad-hoc screen over the columnar mirror (never takes buffer locks)
+    ScreenResult screen(const ScreenQuery& query) const;
 
     // Callbacks for alerts
     using AlertCallback = std::function<void(const AlertData&)>;
     void set_alert_callback(AlertCallback callback);
 
+    // Feed subscriptions, changed at runtime by the bridge's subscribe/
+    // unsubscribe commands (how the aggregator moves symbols). The
+    // callback is bound to the live or mock feed once it is up.
+    using SubscriptionCallback = std::function<void(const std::vector<std::string>& symbols,
+                                                    bool subscribe)>;
+    void set_subscription_callback(SubscriptionCallback callback);
+    
+    // Forwarded to the subscription callback; throws std::runtime_error
+    // before a feed is attached. Unsubscribed symbols leave the live
+    // window at once (exiting the threshold band if in it), and updates
+    // still queued for them are dropped.
+    void subscribe(const std::vector<std::string>& symbols);
+    void unsubscribe(const std::vector<std::string>& symbols);
+
 private:
     struct StockBuffer {
         CircularBuffer<PricePoint> buffer;
@@ -66,15 +150,38 @@ private:
         std::atomic<double> last_price;
         mutable std::shared_mutex mutex;
         
+        // Window state from the last analysis, read lock-free by the
+        // cross-section snapshot; window_min == 0 until first analyzed
+        std::atomic<double> window_min;
+        std::atomic<double> window_max;
+        std::atomic<double> window_open;
+        std::atomic<double> spread_percent;     // -1 until first quote
+        std::atomic<uint64_t> session_volume;   // Trades only
+        int32_t sector_id = -1;
+        int32_t index_id = -1;
+        uint32_t trace_id = 0;  // FlightRecorder symbol id
+        
+        // Guarded by mutex; null unless history_enabled
+        std::unique_ptr<TickHistory> history;
+        
         explicit StockBuffer(size_t capacity) 
-            : buffer(capacity), last_update(0), last_price(0.0) {}
+            : buffer(capacity), last_update(0), last_price(0.0)
+            , window_min(0.0), window_max(0.0), window_open(0.0)
+            , spread_percent(-1.0), session_volume(0) {}
     };
 
     Config config_;
     
     // Lock-free hash map for stock buffers
     mutable std::shared_mutex stocks_mutex_;
-    std::unordered_map<std::string, std::unique_ptr<StockBuffer>> stock_buffers_;
+    // Shared so a buffer outlives its entry for readers and in-flight
+    // updates that found it before cleanup erased it
+    std::unordered_map<std::string, std::shared_ptr<StockBuffer>> stock_buffers_;
+    // Cleaned-up symbols that still hold tick history (window emptied);
+    // revived on their next update. Guarded by stocks_mutex_.
+    std::unordered_map<std::string, std::shared_ptr<StockBuffer>> idle_buffers_;
+    // Unsubscribed and not yet resubscribed; guarded by stocks_mutex_
+    std::unordered_set<std::string> unsubscribed_;
     
     // Threshold tracking
     mutable std::shared_mutex threshold_mutex_;
@@ -83,17 +190,52 @@ private:
     // Performance metrics
     std::atomic<uint64_t> total_updates_{0};
     std::atomic<uint64_t> total_processing_time_ns_{0};
-    std::atomic<uint64_t> updates_last_second_{0};
+    mutable std::atomic<uint64_t> updates_last_second_{0};
     
     // Alert callback
     AlertCallback alert_callback_;
     
+    // Set after the server starts, so guarded; also serializes feed calls
+    std::mutex subscription_mutex_;
+    SubscriptionCallback subscription_callback_;
+    
+    // Cross-sectional stage
+    SectorMap sector_map_;
+    mutable std::shared_mutex cross_section_mutex_;
+    std::shared_ptr<const CrossSectionResult> cross_section_;
+    
+    // Screener mirror, refreshed every screener_refresh_ms
+    Screener screener_;
+    
+    // Shared path for trades and quotes; spread_percent < 0 marks a trade.
+    // `arrival` is taken at submit, before any ingest queue wait.
+    void process_update(const TradeData& trade, double spread_percent,
+                        const IngestPipeline::Arrival& arrival);
+    
+    // Live or idle buffer for read-only accessors (null if unknown); safe
+    // to use after stocks_mutex_ is released
+    std::shared_ptr<const StockBuffer> find_buffer(const std::string& symbol) const;
+    
+    // Audit trail of threshold transitions, written off the hot path
+    std::unique_ptr<AlertJournal> journal_;
+    void journal_alert(JournalEvent event, const AlertData& alert) const;
+    
+    bool is_in_threshold(const std::string& symbol) const;
+    
+    // Shedding rank for the ingest queue: the price that would enter the
+    // threshold band (0 = never shed)
+    double entry_price(const std::string& symbol) const;
+    
+    // Reset first in the destructor: its threads call back into us
+    std::unique_ptr<IngestPipeline> ingest_;
+    
     // SIMD-optimized analysis
     bool analyze_buffer_simd(const StockBuffer& buffer, 
                              double& change_percent,
                              double& min_price,
                              double& max_price,
-                             double& current_price) const;
+                             double& current_price,
+                             double& open_price) const;
     
     // Generate Webull link
     std::string generate_webull_link(const std::string& symbol, 
@@ -101,10 +243,27 @@ private:
     
     // Cleanup thread
     void cleanup_inactive_stocks();
+    
+    // Drops symbols from the live window (parking any tick history) and
+    // journals Exit for those in the threshold band
+    void evict_stocks(const std::vector<std::string>& symbols, uint64_t now);
     std::atomic<bool> running_{true};
     std::thread cleanup_thread_;
+    
+    // Cross-section thread: columnar snapshot + breadth every interval
+    void snapshot_columns(CrossSectionColumns& columns) const;
+    void run_cross_section();
+    std::thread cross_section_thread_;
+    
+    void snapshot_screener(ScreenerSnapshot& snapshot, std::vector<int32_t>& sector_ids) const;
+    void run_screener_refresh();
+    std::thread screener_thread_;
 };
 
+// Bridge payloads: alert pushes and the get_stats response
+void to_json(nlohmann::json& j, const StockMonitor::AlertData& alert);
+void to_json(nlohmann::json& j, const StockMonitor::Stats& stats);
+
 // SIMD-optimized price calculations
 class PriceCalculator {
 public:
@@ -118,6 +277,30 @@ public:
     static void batch_calculate_changes(const std::vector<double>& current_prices,
                                         const std::vector<double>& min_prices,
                                         std::vector<double>& changes_out);
+    
+    // Number of rows where a[i] > b[i]
+    static size_t count_greater_avx2(const double* a, const double* b, size_t count);
+    
+    static void sum_and_squares_avx2(const double* values,
+                                     size_t count,
+                                     double& sum_out,
+                                     double& sum_sq_out);
+    
+    // out[i] = (values[i] - means[g]) * inv_stddevs[g], g = groups[i] + 1
+    // (slot 0 holds the fallback for rows with group -1)
+    static void grouped_zscores_avx2(const double* values,
+                                     const int32_t* groups,
+                                     size_t count,
+                                     const double* means,
+                                     const double* inv_stddevs,
+                                     double* out);
+    
+    // Rows in `group` (all rows if groups is null) with values[i] > threshold
+    static size_t count_above_in_group_avx2(const double* values,
+                                            const int32_t* groups,
+                                            size_t count,
+                                            int32_t group,
+                                            double threshold);
 };
 
 } // namespace stock_monitor
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <nlohmann/json_fwd.hpp>
+
+namespace stock_monitor {
+
+class StockMonitor;
+
+// Engine side of the bridge protocol for commands served from
+// StockMonitor state. ClientServer passes a request's command and data
+// here and wraps the result in its {"type": "response"} line:
+//   get_active_stocks            array of alerts (with market context)
+//   get_stats                    StockMonitor::Stats, sectors included
+//   screen                       ScreenQuery form -> ScreenResult
+//   subscribe / unsubscribe      {"symbols": [...]} -> {"symbols": n}
+//   query_journal                {from, to, symbol, limit} -> newest
+//                                `limit` records, oldest first
+//   get_history                  {symbol, from, to, summary} ->
+//                                {symbol, summary} (null without
+//                                history) or {symbol, ticks: [...]}
+//   dump_trace                   {} -> {"path": ...} once the flight
+//                                recorder dump is written
+// Returns nullopt for commands it does not serve. Throws on malformed
+// data (std::invalid_argument or nlohmann::json::exception) and when
+// the monitor does (e.g. no feed attached); the caller answers with
+// {"error": what()}.
+std::optional<nlohmann::json> handle_bridge_command(StockMonitor& monitor,
+                                                    const std::string& command,
+                                                    const nlohmann::json& data);
+
+} // namespace stock_monitor
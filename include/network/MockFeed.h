@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+namespace stock_monitor {
+
+class StockMonitor;
+
+// Synthetic market data for local runs without Alpaca credentials
+// (`--mock-feed`). Same subscribe/unsubscribe surface as the live feed.
+// Each subscribed symbol random-walks around a start price derived from
+// its name; now and then one gaps up ~11% so threshold alerts fire.
+class MockFeed {
+public:
+    struct Config {
+        double ticks_per_second = 5.0;   // Per symbol
+        double quote_ratio = 0.3;        // Share of ticks sent as quotes
+        double jump_probability = 2e-4;  // Per tick
+        uint64_t seed = 0;               // 0 = random
+    };
+
+    MockFeed(StockMonitor* monitor, const Config& config);
+    ~MockFeed();
+
+    MockFeed(const MockFeed&) = delete;
+    MockFeed& operator=(const MockFeed&) = delete;
+
+    void connect();
+    void disconnect();
+
+    void subscribe(const std::vector<std::string>& symbols);
+    void unsubscribe(const std::vector<std::string>& symbols);
+    size_t symbol_count() const;
+
+private:
+    void run();
+
+    StockMonitor* monitor_;
+    Config config_;
+
+    // Parallel arrays so ticks can pick a random symbol in O(1)
+    mutable std::mutex mutex_;
+    std::vector<std::string> symbols_;
+    std::vector<double> prices_;
+    std::unordered_map<std::string, size_t> index_;
+
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
+
+} // namespace stock_monitor
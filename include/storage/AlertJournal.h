@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+#include <nlohmann/json_fwd.hpp>
+
+namespace stock_monitor {
+
+enum class JournalEvent : uint8_t {
+    Enter = 1,   // Symbol entered the threshold band
+    Update = 2,  // Significant change while in the band
+    Exit = 3     // Left the band (or was evicted as inactive)
+};
+
+// Fixed-size on-disk record, one cache line
+struct alignas(64) JournalRecord {
+    uint64_t timestamp;   // ms since epoch, non-decreasing within the journal
+    char symbol[15];      // NUL-padded
+    JournalEvent event;
+    double change_percent;
+    double current_price;
+    double min_price;
+    double max_price;
+    uint64_t volume;
+};
+static_assert(sizeof(JournalRecord) == 64, "JournalRecord must stay one cache line");
+
+void to_json(nlohmann::json& j, const JournalRecord& record);
+
+// Append-only alert journal in memory-mapped segment files:
+//   <dir>/alerts-YYYYMMDD-NNN.jnl   segments of the current day
+//   <dir>/alerts-YYYYMMDD.jnl       compacted day (all segments merged)
+// Records are handed to a writer thread, so record() never touches disk.
+// On UTC day rollover the previous days are compacted and days older
+// than retention_days are deleted.
+class AlertJournal {
+public:
+    struct Config {
+        std::string directory;
+        size_t segment_records = 1 << 20;  // 64 MB per segment
+        size_t retention_days = 30;
+    };
+
+    struct Stats {
+        uint64_t records;
+        uint64_t segments;
+        uint64_t pending;
+    };
+
+    // Opens existing segments and rebuilds the index; throws std::runtime_error
+    explicit AlertJournal(const Config& config);
+    ~AlertJournal();
+
+    AlertJournal(const AlertJournal&) = delete;
+    AlertJournal& operator=(const AlertJournal&) = delete;
+
+    void record(const JournalRecord& record);
+
+    // Records in [from_ms, to_ms], oldest first; the newest `limit` are
+    // returned when more match. Empty symbol = all symbols.
+    std::vector<JournalRecord> query(uint64_t from_ms,
+                                     uint64_t to_ms,
+                                     const std::string& symbol,
+                                     size_t limit) const;
+
+    Stats get_stats() const;
+
+private:
+    struct Segment;
+
+    struct Location {
+        uint32_t segment;
+        uint32_t record;
+    };
+
+    void run_writer();
+    void append_batch(std::vector<JournalRecord>& batch);
+    void open_active_segment(uint32_t day);
+    void close_active_segment();
+    void load_segments();
+    void compact_closed_days(uint32_t current_day);
+    void rebuild_index();
+
+    const JournalRecord& at(Location location) const;
+
+    Config config_;
+
+    // Segments in (day, sequence) order; the active one is last
+    mutable std::shared_mutex mutex_;
+    std::vector<std::unique_ptr<Segment>> segments_;
+    std::unordered_map<std::string, std::vector<Location>> symbol_index_;
+    Segment* active_ = nullptr;
+    uint32_t active_sequence_ = 0;
+    uint64_t last_timestamp_ = 0;
+
+    std::mutex pending_mutex_;
+    std::vector<JournalRecord> pending_;
+    std::atomic<uint64_t> pending_count_{0};
+
+    std::atomic<bool> running_{true};
+    std::thread writer_thread_;
+};
+
+} // namespace stock_monitor
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <nlohmann/json_fwd.hpp>
+#include "core/PriceData.h"
+
+namespace stock_monitor {
+
+constexpr size_t kTickBlockBytes = 1024;
+
+// Header of a compressed block; lets window queries skip whole blocks.
+// first_ts/last_ts bound every tick in the block (see TickHistory::append).
+struct TickBlockHeader {
+    uint64_t first_ts;
+    uint64_t last_ts;
+    double first_price;
+    double last_price;
+    double min_price;
+    double max_price;
+    uint64_t volume;
+    uint32_t count;
+    uint32_t bit_length;
+};
+static_assert(sizeof(TickBlockHeader) == 64, "Block header is one cache line");
+
+// Fixed-size block: timestamps as delta-of-delta, prices as XOR against
+// the previous price (Gorilla), volumes as LEB128 varints, all in one
+// MSB-first bit stream. The first tick's time and price live in the header.
+struct alignas(64) TickBlock {
+    TickBlockHeader header;
+    uint8_t data[kTickBlockBytes - sizeof(TickBlockHeader)];
+};
+
+// Long-horizon per-symbol tick history fed by the live ring. Not
+// thread-safe; StockMonitor guards it with the symbol's buffer mutex.
+// A timestamp older than the newest one stored (a late print) is clamped
+// up to it, as the alert journal does, so blocks stay time-ordered and
+// window queries can trust block bounds.
+class TickHistory {
+public:
+    struct Summary {
+        size_t count = 0;
+        uint64_t first_ts = 0;
+        uint64_t last_ts = 0;
+        double first_price = 0.0;
+        double last_price = 0.0;
+        double min_price = 0.0;
+        double max_price = 0.0;
+        uint64_t volume = 0;
+    };
+
+    // max_blocks = 0 keeps everything; otherwise the oldest blocks drop
+    explicit TickHistory(size_t max_blocks = 0);
+
+    void append(const PricePoint& point);
+
+    // Aggregates over [from_ts, to_ts]; only edge blocks are decoded
+    Summary summarize(uint64_t from_ts, uint64_t to_ts) const;
+
+    // Decodes ticks in [from_ts, to_ts] into `out` (appended)
+    void decode(uint64_t from_ts, uint64_t to_ts, std::vector<PricePoint>& out) const;
+
+    size_t tick_count() const { return tick_count_; }
+    size_t block_count() const { return blocks_.size(); }
+    size_t memory_bytes() const { return blocks_.size() * sizeof(TickBlock); }
+    size_t encoded_bits() const;
+
+    static void decode_block(const TickBlock& block, std::vector<PricePoint>& out);
+
+private:
+    void start_block(const PricePoint& point);
+
+    size_t max_blocks_;
+    size_t tick_count_ = 0;
+    uint64_t last_ts_ = 0;  // Newest stored timestamp, kept across evictions
+    std::deque<std::unique_ptr<TickBlock>> blocks_;  // Last one is open
+
+    // Encoder state for the open block
+    int64_t prev_delta_ = 0;
+    uint64_t prev_price_bits_ = 0;
+    uint32_t prev_leading_ = 0;
+    uint32_t prev_trailing_ = 0;
+};
+
+// Bridge payloads for get_history
+void to_json(nlohmann::json& j, const TickHistory::Summary& summary);
+void to_json(nlohmann::json& j, const PricePoint& point);
+
+} // namespace stock_monitor
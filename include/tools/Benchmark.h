@@ -0,0 +1,11 @@
+#pragma once
+
+#include <ostream>
+
+namespace stock_monitor {
+
+// Offline micro-benchmarks, run with `stock_monitor_engine --benchmark`.
+// Returns a process exit code (non-zero if a round-trip check fails).
+int run_benchmarks(std::ostream& out);
+
+} // namespace stock_monitor
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include "utils/FlightRecorder.h"
+
+namespace stock_monitor {
+
+// Chrome trace event JSON (chrome://tracing, ui.perfetto.dev). Times are
+// microseconds since the recorder was configured.
+void write_chrome_trace(const TraceDump& dump, std::ostream& out);
+
+// `stock_monitor_engine --convert-trace FILE`: writes FILE.json.
+// Returns a process exit code.
+int convert_trace(const std::string& path, std::ostream& log);
+
+} // namespace stock_monitor
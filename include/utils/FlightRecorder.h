@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <x86intrin.h>
+
+namespace stock_monitor {
+
+enum class TraceEventType : uint8_t {
+    TickReceived = 1,  // tsc = submit, duration = cycles queued before processing, arg = volume
+    LockWaited = 2,    // duration = cycles spent acquiring the buffer lock
+    Analyzed = 3,      // duration = cycles in the window analysis
+    AlertEmitted = 4   // arg = change percent in basis points
+};
+
+const char* trace_event_name(TraceEventType type);
+
+// Fixed binary event, two per cache line
+struct TraceEvent {
+    uint64_t tsc;        // Start time (rdtsc)
+    uint64_t duration;   // Cycles; 0 for instant events
+    uint64_t arg;
+    uint32_t symbol_id;  // FlightRecorder::intern_symbol id, 0 = none
+    TraceEventType type;
+    uint8_t reserved[3];
+};
+static_assert(sizeof(TraceEvent) == 32, "TraceEvent must stay 32 bytes");
+
+enum class DumpReason : uint8_t {
+    Signal = 1,   // SIGUSR1
+    Request = 2,  // Bridge command
+    Latency = 3   // An update exceeded the latency trigger
+};
+
+const char* dump_reason_name(DumpReason reason);
+
+// Contents of a dump file, as read back by load_dump()
+struct TraceDump {
+    struct Thread {
+        uint32_t tid;
+        std::string name;
+        std::vector<TraceEvent> events;  // Oldest first
+    };
+
+    DumpReason reason;
+    uint64_t trigger_tsc;
+    uint64_t base_tsc;       // rdtsc at configure()
+    uint64_t base_unix_ns;   // Wall clock at base_tsc
+    double tsc_per_ns;
+    std::vector<Thread> threads;
+    std::vector<std::string> symbols;  // Indexed by symbol_id
+};
+
+// Always-on flight recorder: every thread that records gets its own
+// single-producer ring, so record() is a TSC read plus a 32-byte store.
+// The newest `ring_events` per thread are kept; dump() snapshots all
+// rings into <directory>/trace-YYYYMMDD-HHMMSS-<reason>.smtr without
+// stopping the writers (slots overwritten mid-copy are discarded).
+// Dumps are written by a housekeeping thread when requested from a
+// signal handler or a latency trigger, or synchronously via dump().
+class FlightRecorder {
+public:
+    struct Config {
+        size_t ring_events = 1 << 16;  // Per thread, rounded up to a power of two; 0 = off
+        std::string directory = ".";
+        uint64_t min_dump_interval_ms = 10000;  // Rate limit for triggered dumps
+    };
+
+    // Call once at startup, before any thread records
+    static void configure(const Config& config);
+    static void start();
+    static void stop();
+
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    static uint64_t now() { return __rdtsc(); }
+
+    static void record(TraceEventType type, uint32_t symbol_id, uint64_t tsc,
+                       uint64_t duration = 0, uint64_t arg = 0) {
+        if (!enabled()) return;
+        Ring* ring = ring_ ? ring_ : attach();
+        uint64_t head = ring->head.load(std::memory_order_relaxed);
+        TraceEvent& event = ring->events[head & ring->mask];
+        event.tsc = tsc;
+        event.duration = duration;
+        event.arg = arg;
+        event.symbol_id = symbol_id;
+        event.type = type;
+        ring->head.store(head + 1, std::memory_order_release);
+    }
+
+    // Stable id for trace events; cold path (call when a symbol is first seen)
+    static uint32_t intern_symbol(const std::string& symbol);
+
+    // Async-signal-safe; the dump thread writes it shortly after
+    static void request_dump(DumpReason reason);
+
+    // Rate-limited request for latency spikes
+    static void trigger(DumpReason reason);
+
+    // Writes a dump now and returns its path; throws std::runtime_error
+    static std::string dump(DumpReason reason);
+
+    // Reads a dump file; throws std::runtime_error
+    static TraceDump load_dump(const std::string& path);
+
+private:
+    struct Ring {
+        std::unique_ptr<TraceEvent[]> events;
+        uint64_t mask;
+        std::atomic<uint64_t> head{0};  // Total events ever recorded
+        uint32_t tid;
+        std::string name;
+    };
+
+    struct State;
+    static State& state();
+
+    static Ring* attach();
+    static void run_dumper();
+
+    static std::atomic<bool> enabled_;
+    static inline thread_local Ring* ring_ = nullptr;
+};
+
+} // namespace stock_monitor
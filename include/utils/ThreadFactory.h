@@ -0,0 +1,94 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+namespace stock_monitor {
+
+// Classes of engine threads that share a placement policy
+enum class ThreadRole {
+    Decoder,       // Feed socket read + JSON decode
+    Ingest,        // StockMonitor shards (process_trade)
+    Dispatcher,    // Alert fan-out to clients
+    Server,        // Bridge server I/O
+    Housekeeping   // Cleanup, stats, journal flush
+};
+
+const char* thread_role_name(ThreadRole role);
+
+struct ThreadPlacement {
+    std::vector<int> cores;            // Empty = float over the startup CPU mask
+    int numa_node = -1;                // -1 = node of the pinned core
+    bool busy_poll = false;            // Spin instead of sleeping when idle
+    uint32_t spin_iterations = 20000;  // Pause-spins before backing off
+    uint32_t backoff_max_us = 1000;    // Sleep cap; 0 + busy_poll = never sleep
+};
+
+struct ThreadTopology {
+    ThreadPlacement decoder;
+    ThreadPlacement ingest;
+    ThreadPlacement dispatcher;
+    ThreadPlacement server;
+    ThreadPlacement housekeeping;
+
+    ThreadPlacement& placement(ThreadRole role);
+    const ThreadPlacement& placement(ThreadRole role) const;
+};
+
+// Idle policy for polling loops: spin with PAUSE, then exponential sleep
+class IdleStrategy {
+public:
+    explicit IdleStrategy(const ThreadPlacement& placement);
+
+    void idle();
+    void reset() {
+        idle_count_ = 0;
+        backoff_us_ = 1;
+    }
+
+private:
+    uint32_t spin_limit_;
+    uint32_t backoff_max_us_;
+    uint32_t idle_count_ = 0;
+    uint32_t backoff_us_ = 1;
+};
+
+// Single creation point for engine threads. Applies the thread name,
+// core pinning and a NUMA-preferred memory policy before the body runs,
+// so state allocated by the thread is first-touched on its local node.
+class ThreadFactory {
+public:
+    // Call once at startup, before any engine thread is spawned. Throws
+    // std::invalid_argument for cores outside the startup CPU mask.
+    static void configure(const ThreadTopology& topology);
+    static const ThreadTopology& topology();
+
+    // `index` picks a core from the role's list (e.g. ingest shard number)
+    template<typename Fn>
+    static std::thread spawn(ThreadRole role, std::string name, Fn&& fn, size_t index = 0) {
+        return std::thread([role, name = std::move(name), index,
+                            fn = std::forward<Fn>(fn)]() mutable {
+            apply_to_current(role, name, index);
+            fn();
+        });
+    }
+
+    // Apply placement to the calling thread (used for the main thread)
+    static void apply_to_current(ThreadRole role, const std::string& name, size_t index = 0);
+
+    static IdleStrategy idle_strategy(ThreadRole role) {
+        return IdleStrategy(topology().placement(role));
+    }
+
+    // NUMA node a thread of this role/index runs on, -1 if unknown
+    static int numa_node_of(ThreadRole role, size_t index = 0);
+
+    // Parse "0-3,8,10-11" into a core list; throws std::invalid_argument
+    static std::vector<int> parse_cpu_list(const std::string& spec);
+};
+
+} // namespace stock_monitor
@@ -0,0 +1,82 @@
+#include <iostream>
+#include <csignal>
+#include "cluster/Aggregator.h"
+#include "utils/ThreadFactory.h"
+#include <boost/asio/signal_set.hpp>
+#include <boost/program_options.hpp>
+
+namespace po = boost::program_options;
+using namespace stock_monitor;
+
+int main(int argc, char* argv[]) {
+    po::options_description desc("Stock Monitor Aggregator Options");
+    desc.add_options()
+        ("help,h", "Show help message")
+        ("port,p", po::value<uint16_t>()->default_value(8080), "Bridge port for CppEngineBridge clients")
+        ("engine", po::value<std::vector<std::string>>()->multitoken()->required(),
+         "Engine instance as id=host:port (repeatable; id must match its --partition-id)")
+        ("symbols-file", po::value<std::string>()->required(), "Universe to partition, one symbol per line")
+        ("failover-ms", po::value<uint64_t>()->default_value(3000), "Grace before a lost instance's symbols move")
+        ("reconnect-ms", po::value<uint64_t>()->default_value(1000), "Retry interval for lost instances")
+        ("request-timeout-ms", po::value<uint64_t>()->default_value(2000), "Fan-out reply deadline")
+        ("stats-interval-ms", po::value<uint64_t>()->default_value(1000), "Merged stats push interval")
+        ("cpu", po::value<std::string>()->default_value(""), "Cores for the aggregator thread (e.g. 2)");
+
+    po::variables_map vm;
+
+    try {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+
+        if (vm.count("help")) {
+            std::cout << desc << std::endl;
+            return 0;
+        }
+
+        po::notify(vm);
+    } catch (const po::error& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        std::cerr << desc << std::endl;
+        return 1;
+    }
+
+    try {
+        ThreadTopology topology;
+        topology.server.cores = ThreadFactory::parse_cpu_list(vm["cpu"].as<std::string>());
+        ThreadFactory::configure(topology);
+        ThreadFactory::apply_to_current(ThreadRole::Server, "sm-aggregator");
+
+        Aggregator::Config config;
+        config.port = vm["port"].as<uint16_t>();
+        for (const auto& spec : vm["engine"].as<std::vector<std::string>>()) {
+            config.engines.push_back(EngineEndpoint::parse(spec));
+        }
+        config.symbols = load_symbol_list(vm["symbols-file"].as<std::string>());
+        config.failover_ms = vm["failover-ms"].as<uint64_t>();
+        config.reconnect_ms = vm["reconnect-ms"].as<uint64_t>();
+        config.request_timeout_ms = vm["request-timeout-ms"].as<uint64_t>();
+        config.stats_interval_ms = vm["stats-interval-ms"].as<uint64_t>();
+
+        boost::asio::io_context io;
+        Aggregator aggregator(io, config);
+        aggregator.start();
+
+        std::cout << "Aggregator listening on port " << config.port << " for "
+                  << config.engines.size() << " instances, "
+                  << config.symbols.size() << " symbols" << std::endl;
+
+        boost::asio::signal_set signals(io, SIGINT, SIGTERM);
+        signals.async_wait([&](const boost::system::error_code&, int signal) {
+            std::cout << "\nReceived signal " << signal << ", shutting down..." << std::endl;
+            aggregator.stop();
+            io.stop();
+        });
+
+        io.run();
+    } catch (const std::exception& e) {
+        std::cerr << "Fatal error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Shutdown complete" << std::endl;
+    return 0;
+}
@@ -0,0 +1,995 @@
+#include "cluster/Aggregator.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <boost/asio/connect.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/streambuf.hpp>
+#include <boost/asio/write.hpp>
+
+namespace stock_monitor {
+
+namespace asio = boost::asio;
+using asio::ip::tcp;
+using nlohmann::json;
+using namespace std::chrono;
+
+namespace {
+
+constexpr size_t kMaxLineBytes = 64 << 20;
+
+// Queued lines before a client that stopped reading is dropped
+constexpr size_t kMaxClientBacklog = 10000;
+
+// Newline-delimited JSON over one socket. Handlers carry the connection
+// generation, so callbacks from before a close() are ignored.
+template<typename Derived>
+class LineConnection : public std::enable_shared_from_this<Derived> {
+protected:
+    explicit LineConnection(asio::io_context& io)
+        : socket_(io), input_(kMaxLineBytes) {}
+    explicit LineConnection(tcp::socket socket)
+        : socket_(std::move(socket)), input_(kMaxLineBytes) {}
+
+    void read_next() {
+        asio::async_read_until(socket_, input_, '\n',
+            [self = this->shared_from_this(), generation = generation_](
+                const boost::system::error_code& ec, size_t) {
+                if (generation != self->generation_) return;
+                if (ec) {
+                    self->on_closed();
+                    return;
+                }
+                std::istream stream(&self->input_);
+                std::string line;
+                std::getline(stream, line);
+                if (!line.empty()) {
+                    self->on_line(line);
+                }
+                if (generation == self->generation_) {
+                    self->read_next();
+                }
+            });
+    }
+
+    void write_line(std::string line) {
+        output_.push_back(std::move(line));
+        if (output_.size() == 1) {
+            write_next();
+        }
+    }
+
+    void close() {
+        ++generation_;
+        boost::system::error_code ignored;
+        socket_.close(ignored);
+        input_.consume(input_.size());
+        output_.clear();
+    }
+
+    tcp::socket socket_;
+    asio::streambuf input_;
+    std::deque<std::string> output_;
+    uint64_t generation_ = 0;
+
+private:
+    void write_next() {
+        asio::async_write(socket_, asio::buffer(output_.front()),
+            [self = this->shared_from_this(), generation = generation_](
+                const boost::system::error_code& ec, size_t) {
+                if (generation != self->generation_) return;
+                if (ec) {
+                    self->on_closed();
+                    return;
+                }
+                self->output_.pop_front();
+                if (!self->output_.empty()) {
+                    self->write_next();
+                }
+            });
+    }
+};
+
+std::string response_line(const json& id, json data) {
+    return json{{"type", "response"}, {"id", id}, {"data", std::move(data)}}.dump() + "\n";
+}
+
+// Lenient field readers: json::value() throws on non-objects and on
+// fields of the wrong type, and any line here comes off the network
+double number_or(const json& j, const char* key, double fallback) {
+    auto it = j.find(key);
+    return (it != j.end() && it->is_number()) ? it->get<double>() : fallback;
+}
+
+std::string string_or(const json& j, const char* key, const std::string& fallback) {
+    auto it = j.find(key);
+    return (it != j.end() && it->is_string()) ? it->get<std::string>() : fallback;
+}
+
+uint64_t timestamp_of(const json& j) {
+    auto it = j.find("timestamp");
+    return (it != j.end() && it->is_number_unsigned()) ? it->get<uint64_t>() : 0;
+}
+
+// Absent = fallback; anything but a non-negative integer throws
+size_t limit_of(const json& data, size_t fallback) {
+    auto it = data.find("limit");
+    if (it == data.end()) return fallback;
+    if (!it->is_number_unsigned()) {
+        throw std::invalid_argument("limit must be a non-negative integer");
+    }
+    return it->get<size_t>();
+}
+
+// An alert's market context (ranks, sizes, z-scores, breadth) is computed
+// by its owner over that instance's slice only; say so and say whose
+void mark_partition_context(json& alert, const std::string& node) {
+    auto context = alert.find("context");
+    if (context == alert.end() || !context->is_object()) return;
+    (*context)["scope"] = "partition";
+    (*context)["instance"] = node;
+}
+
+// Sector aggregates merged by name, with pooled standard deviations
+json merge_sectors(const std::vector<const json*>& lists) {
+    struct Acc {
+        double count = 0, advancing = 0, sum = 0, sum_sq = 0;
+    };
+    std::map<std::string, Acc> by_name;
+
+    for (const json* list : lists) {
+        for (const auto& sector : *list) {
+            if (!sector.is_object()) continue;
+            auto& acc = by_name[string_or(sector, "name", "")];
+            double n = number_or(sector, "count", 0.0);
+            double mean = number_or(sector, "avg_change", 0.0);
+            double sd = number_or(sector, "stddev_change", 0.0);
+            acc.count += n;
+            acc.advancing += number_or(sector, "advancing", 0.0);
+            acc.sum += n * mean;
+            acc.sum_sq += n * (sd * sd + mean * mean);
+        }
+    }
+
+    json merged = json::array();
+    for (const auto& [name, acc] : by_name) {
+        double mean = acc.count > 0 ? acc.sum / acc.count : 0.0;
+        double var = acc.count > 0 ? std::max(acc.sum_sq / acc.count - mean * mean, 0.0) : 0.0;
+        merged.push_back({
+            {"name", name},
+            {"count", static_cast<uint64_t>(acc.count)},
+            {"advancing", static_cast<uint64_t>(acc.advancing)},
+            {"avg_change", mean},
+            {"stddev_change", std::sqrt(var)}
+        });
+    }
+    return merged;
+}
+
+// Counters add up, lags take the worst instance, averages are weighted
+// (processing time by update rate, breadth by symbols tracked)
+json merge_stat_objects(const std::vector<const json*>& all) {
+    static const std::pair<const char*, const char*> kWeighted[] = {
+        {"avg_processing_time_us", "updates_per_second"},
+        {"advancing_pct", "total_stocks"},
+        {"avg_change", "total_stocks"}
+    };
+    static const char* kMax[] = {
+        "ingest_lag_us", "max_ingest_lag_us", "cross_section_time_us"
+    };
+
+    json merged = json::object();
+    std::vector<const json*> sector_lists;
+
+    for (const json* stats : all) {
+        if (!stats->is_object()) continue;
+        for (const auto& [key, value] : stats->items()) {
+            if (key == "sectors" && value.is_array()) {
+                sector_lists.push_back(&value);
+            } else if (value.is_boolean()) {
+                auto current = merged.find(key);
+                bool prior = current != merged.end() && current->is_boolean() && current->get<bool>();
+                merged[key] = prior || value.get<bool>();
+            } else if (value.is_number()) {
+                bool is_max = std::any_of(std::begin(kMax), std::end(kMax),
+                                          [&key](const char* name) { return key == name; });
+                auto current = merged.find(key);
+                bool integral = value.is_number_integer() &&
+                    (current == merged.end() || current->is_number_integer());
+                if (integral) {
+                    int64_t prior = current != merged.end() ? current->get<int64_t>() : 0;
+                    merged[key] = is_max ? std::max(prior, value.get<int64_t>())
+                                         : prior + value.get<int64_t>();
+                } else {
+                    double prior = number_or(merged, key.c_str(), 0.0);
+                    merged[key] = is_max ? std::max(prior, value.get<double>())
+                                         : prior + value.get<double>();
+                }
+            }
+        }
+    }
+
+    for (const auto& [field, weight_field] : kWeighted) {
+        double weighted = 0.0, weights = 0.0, plain = 0.0;
+        size_t present = 0;
+        for (const json* stats : all) {
+            if (!stats->is_object() || !stats->contains(field)) continue;
+            double value = number_or(*stats, field, 0.0);
+            double weight = number_or(*stats, weight_field, 0.0);
+            weighted += value * weight;
+            weights += weight;
+            plain += value;
+            ++present;
+        }
+        if (present > 0) {
+            merged[field] = weights > 0.0 ? weighted / weights : plain / present;
+        }
+    }
+
+    if (!sector_lists.empty()) {
+        merged["sectors"] = merge_sectors(sector_lists);
+    }
+    merged["instances_reporting"] = all.size();
+    return merged;
+}
+
+} // namespace
+
+EngineEndpoint EngineEndpoint::parse(const std::string& spec) {
+    EngineEndpoint endpoint;
+    std::string address = spec;
+
+    auto eq = spec.find('=');
+    if (eq != std::string::npos) {
+        endpoint.id = spec.substr(0, eq);
+        address = spec.substr(eq + 1);
+    }
+
+    auto colon = address.rfind(':');
+    if (colon == std::string::npos || colon == 0 || colon + 1 == address.size()) {
+        throw std::invalid_argument("Engine must be [id=]host:port: " + spec);
+    }
+    endpoint.host = address.substr(0, colon);
+    try {
+        int port = std::stoi(address.substr(colon + 1));
+        if (port <= 0 || port > 65535) throw std::out_of_range("port");
+        endpoint.port = static_cast<uint16_t>(port);
+    } catch (const std::exception&) {
+        throw std::invalid_argument("Bad engine port: " + spec);
+    }
+
+    if (endpoint.id.empty()) {
+        endpoint.id = address;
+    }
+    return endpoint;
+}
+
+// Upstream connection to one engine instance; reconnects forever
+class Aggregator::EngineLink : public LineConnection<EngineLink> {
+public:
+    EngineLink(Aggregator& owner, const EngineEndpoint& endpoint)
+        : LineConnection(owner.io_)
+        , failover_timer(owner.io_)
+        , owner_(owner)
+        , endpoint_(endpoint)
+        , resolver_(owner.io_)
+        , retry_timer_(owner.io_) {}
+
+    const EngineEndpoint& endpoint() const { return endpoint_; }
+    bool connected() const { return connected_; }
+
+    void connect() {
+        resolver_.async_resolve(endpoint_.host, std::to_string(endpoint_.port),
+            [self = shared_from_this()](const boost::system::error_code& ec,
+                                        tcp::resolver::results_type results) {
+                if (self->stopped_) return;
+                if (ec) {
+                    self->schedule_reconnect();
+                    return;
+                }
+                asio::async_connect(self->socket_, results,
+                    [self](const boost::system::error_code& ec, const tcp::endpoint&) {
+                        if (self->stopped_) return;
+                        if (ec) {
+                            self->close();
+                            self->schedule_reconnect();
+                            return;
+                        }
+                        self->connected_ = true;
+                        self->socket_.set_option(tcp::no_delay(true));
+                        std::cout << "[CLUSTER] Connected to " << self->endpoint_.id << " at "
+                                  << self->endpoint_.host << ":" << self->endpoint_.port << std::endl;
+                        self->read_next();
+                        self->owner_.on_link_up(*self);
+                    });
+            });
+    }
+
+    void shutdown() {
+        stopped_ = true;
+        retry_timer_.cancel();
+        failover_timer.cancel();
+        resolver_.cancel();
+        connected_ = false;
+        close();
+        fail_pending();
+    }
+
+    // `done` gets the response data, or nullptr if the link drops first
+    void send(const std::string& command, const json& data,
+              std::function<void(const json*)> done) {
+        if (!connected_) {
+            asio::post(owner_.io_, [done = std::move(done)] { done(nullptr); });
+            return;
+        }
+
+        expire_pending();
+        uint64_t id = ++next_id_;
+        auto deadline = steady_clock::now() + milliseconds(owner_.config_.request_timeout_ms);
+        pending_.emplace(id, Pending{deadline, std::move(done)});
+        write_line(json{{"id", std::to_string(id)}, {"command", command}, {"data", data}}.dump() + "\n");
+    }
+
+    void on_line(const std::string& line) {
+        json message;
+        try {
+            message = json::parse(line);
+        } catch (const json::exception& e) {
+            std::cerr << "[CLUSTER] Bad message from " << endpoint_.id << ": " << e.what() << std::endl;
+            return;
+        }
+        if (!message.is_object()) {
+            std::cerr << "[CLUSTER] Bad message from " << endpoint_.id << ": not an object" << std::endl;
+            return;
+        }
+
+        if (string_or(message, "type", "") != "response") {
+            owner_.on_push(*this, message, line);
+            return;
+        }
+
+        uint64_t id = 0;
+        try {
+            const auto& raw = message.at("id");
+            id = raw.is_string() ? std::stoull(raw.get<std::string>()) : raw.get<uint64_t>();
+        } catch (const std::exception&) {
+            return;
+        }
+
+        auto it = pending_.find(id);
+        if (it == pending_.end()) return;  // Timed out already
+        auto done = std::move(it->second.done);
+        pending_.erase(it);
+
+        static const json null_data;
+        auto data = message.find("data");
+        done(data != message.end() ? &*data : &null_data);
+    }
+
+    void on_closed() {
+        bool was_connected = connected_;
+        connected_ = false;
+        close();
+        fail_pending();
+        if (was_connected) {
+            std::cout << "[CLUSTER] Lost " << endpoint_.id << std::endl;
+            owner_.on_link_down(*this);
+        }
+        schedule_reconnect();
+    }
+
+    bool in_ring = false;
+    asio::steady_timer failover_timer;
+
+private:
+    struct Pending {
+        steady_clock::time_point deadline;
+        std::function<void(const json*)> done;
+    };
+
+    void schedule_reconnect() {
+        if (stopped_) return;
+        retry_timer_.expires_after(milliseconds(owner_.config_.reconnect_ms));
+        retry_timer_.async_wait([self = shared_from_this()](const boost::system::error_code& ec) {
+            if (!ec && !self->stopped_) {
+                self->connect();
+            }
+        });
+    }
+
+    // Ids are issued in time order, so expired requests sit at the front.
+    // Their fan-outs have already replied; this just bounds the map when
+    // an engine ignores a command.
+    void expire_pending() {
+        auto now = steady_clock::now();
+        while (!pending_.empty() && pending_.begin()->second.deadline < now) {
+            pending_.erase(pending_.begin());
+        }
+    }
+
+    void fail_pending() {
+        auto pending = std::move(pending_);
+        pending_.clear();
+        for (auto& [id, request] : pending) {
+            request.done(nullptr);
+        }
+    }
+
+    Aggregator& owner_;
+    EngineEndpoint endpoint_;
+    tcp::resolver resolver_;
+    asio::steady_timer retry_timer_;
+    bool connected_ = false;
+    bool stopped_ = false;
+    uint64_t next_id_ = 0;
+    std::map<uint64_t, Pending> pending_;
+
+    friend class LineConnection<EngineLink>;
+};
+
+// Downstream bridge client
+class Aggregator::ClientSession : public LineConnection<ClientSession> {
+public:
+    ClientSession(Aggregator& owner, tcp::socket socket)
+        : LineConnection(std::move(socket)), owner_(owner) {}
+
+    void start() {
+        read_next();
+    }
+
+    void send(std::string line) {
+        if (output_.size() >= kMaxClientBacklog) {
+            std::cerr << "[CLUSTER] Dropping client that stopped reading" << std::endl;
+            on_closed();
+            return;
+        }
+        write_line(std::move(line));
+    }
+
+    // A bad line gets an error response; it never reaches io.run()
+    void on_line(const std::string& line) {
+        json id;
+        try {
+            json request = json::parse(line);
+            if (!request.is_object()) {
+                throw std::invalid_argument("request must be a JSON object");
+            }
+            auto it = request.find("id");
+            if (it != request.end()) id = *it;
+            owner_.handle_request(shared_from_this(), request);
+        } catch (const std::exception& e) {
+            std::cerr << "[CLUSTER] Bad request: " << e.what() << std::endl;
+            send(response_line(id, json{{"error", std::string("Bad request: ") + e.what()}}));
+        }
+    }
+
+    void on_closed() {
+        close();
+        owner_.sessions_.erase(shared_from_this());
+    }
+
+    void shutdown() {
+        close();
+    }
+
+private:
+    Aggregator& owner_;
+
+    friend class LineConnection<ClientSession>;
+};
+
+struct Aggregator::FanOut {
+    explicit FanOut(asio::io_context& io) : timer(io) {}
+
+    void finish() {
+        if (finished) return;
+        finished = true;
+        timer.cancel();
+        json merged;
+        try {
+            merged = merge(results);
+        } catch (const std::exception& e) {
+            std::cerr << "[CLUSTER] Merge failed: " << e.what() << std::endl;
+            merged = json{{"error", std::string("Merge failed: ") + e.what()}};
+        }
+        reply(std::move(merged));
+    }
+
+    asio::steady_timer timer;
+    size_t expected = 0;
+    size_t received = 0;
+    bool finished = false;
+    Results results;
+    Merge merge;
+    Reply reply;
+};
+
+Aggregator::Aggregator(asio::io_context& io, const Config& config)
+    : io_(io)
+    , config_(config)
+    , acceptor_(io)
+    , stats_timer_(io) {
+}
+
+Aggregator::~Aggregator() {
+    stop();
+}
+
+void Aggregator::start() {
+    tcp::endpoint endpoint(tcp::v4(), config_.port);
+    acceptor_.open(endpoint.protocol());
+    acceptor_.set_option(tcp::acceptor::reuse_address(true));
+    acceptor_.bind(endpoint);
+    acceptor_.listen();
+    running_ = true;
+
+    // Start from the full membership, which is what each engine used to
+    // compute its startup slice; instances that never come up are
+    // dropped after failover_ms like any other loss
+    for (const auto& endpoint : config_.engines) {
+        auto link = std::make_shared<EngineLink>(*this, endpoint);
+        ring_.add_node(endpoint.id);
+        link->in_ring = true;
+        links_.push_back(link);
+    }
+    change_universe(config_.symbols, true);
+
+    for (const auto& link : links_) {
+        on_link_down(*link);
+        link->connect();
+    }
+
+    accept();
+    schedule_stats();
+}
+
+void Aggregator::stop() {
+    if (!running_) return;
+    running_ = false;
+
+    boost::system::error_code ignored;
+    acceptor_.close(ignored);
+    stats_timer_.cancel();
+
+    for (const auto& link : links_) {
+        link->shutdown();
+    }
+    for (const auto& session : sessions_) {
+        session->shutdown();
+    }
+    sessions_.clear();
+}
+
+void Aggregator::accept() {
+    acceptor_.async_accept([this](const boost::system::error_code& ec, tcp::socket socket) {
+        if (!running_) return;
+        if (!ec) {
+            socket.set_option(tcp::no_delay(true));
+            auto session = std::make_shared<ClientSession>(*this, std::move(socket));
+            sessions_.insert(session);
+            session->start();
+        }
+        accept();
+    });
+}
+
+void Aggregator::on_link_up(EngineLink& link) {
+    link.failover_timer.cancel();
+
+    const std::string& node = link.endpoint().id;
+    if (!link.in_ring) {
+        ring_.add_node(node);
+        link.in_ring = true;
+        std::cout << "[CLUSTER] " << node << " joined the ring" << std::endl;
+        rebalance(node);
+    }
+    reconcile(node);
+}
+
+void Aggregator::reconcile(const std::string& node) {
+    // Whatever the instance holds is unknown: it may have restarted with
+    // its static slice, or missed unsubscribes (sends to a down link are
+    // dropped) from rebalances and universe removals while it was away
+    std::vector<std::string> owned;
+    std::vector<std::string> stale(retired_.begin(), retired_.end());
+    for (const auto& symbol : universe_) {
+        (owner_[symbol] == node ? owned : stale).push_back(symbol);
+    }
+    send_subscriptions(node, "unsubscribe", stale);
+    send_subscriptions(node, "subscribe", owned);
+}
+
+void Aggregator::on_link_down(EngineLink& link) {
+    if (!link.in_ring) return;
+
+    link.failover_timer.expires_after(milliseconds(config_.failover_ms));
+    link.failover_timer.async_wait([this, self = link.shared_from_this()](
+                                       const boost::system::error_code& ec) {
+        if (ec || !running_ || self->connected() || !self->in_ring) return;
+        ring_.remove_node(self->endpoint().id);
+        self->in_ring = false;
+        std::cout << "[CLUSTER] " << self->endpoint().id << " left the ring" << std::endl;
+        rebalance();
+    });
+}
+
+void Aggregator::on_push(EngineLink& link, const json& message, const std::string& line) {
+    std::string type = string_or(message, "type", "");
+
+    if (type == "alert" || type == "update") {
+        auto data = message.find("data");
+        std::string symbol = data != message.end() ? string_or(*data, "symbol", "") : "";
+        if (!owns(link.endpoint().id, symbol)) return;
+        if (data->contains("context")) {
+            json tagged = message;
+            mark_partition_context(tagged["data"], link.endpoint().id);
+            broadcast(tagged.dump() + "\n");
+        } else {
+            broadcast(line + "\n");
+        }
+    } else if (type != "stats") {
+        // Per-instance stats are replaced by the merged push
+        broadcast(line + "\n");
+    }
+}
+
+// `reconciling` is about to get its full slice from reconcile(), so no
+// subscribe is sent to it here
+void Aggregator::rebalance(const std::string& reconciling) {
+    std::unordered_map<std::string, std::vector<std::string>> to_subscribe;
+    std::unordered_map<std::string, std::vector<std::string>> to_unsubscribe;
+    size_t moved = 0;
+
+    for (const auto& symbol : universe_) {
+        auto& current = owner_[symbol];
+        const std::string& next = ring_.owner(symbol);
+        if (current == next) continue;
+
+        if (!current.empty()) to_unsubscribe[current].push_back(symbol);
+        if (!next.empty()) to_subscribe[next].push_back(symbol);
+        current = next;
+        ++moved;
+    }
+
+    // Old owners drop first so a symbol is briefly unowned rather than
+    // double-fed; pushes from non-owners are filtered either way
+    for (const auto& [node, symbols] : to_unsubscribe) {
+        send_subscriptions(node, "unsubscribe", symbols);
+    }
+    for (const auto& [node, symbols] : to_subscribe) {
+        if (node != reconciling) {
+            send_subscriptions(node, "subscribe", symbols);
+        }
+    }
+
+    if (moved > 0) {
+        std::cout << "[CLUSTER] Rebalanced " << moved << " of " << universe_.size()
+                  << " symbols across " << ring_.nodes().size() << " instances" << std::endl;
+    }
+}
+
+void Aggregator::send_subscriptions(const std::string& node, const char* command,
+                                    const std::vector<std::string>& symbols) {
+    if (symbols.empty()) return;
+    EngineLink* link = link_for(node);
+    if (!link || !link->connected()) return;  // reconcile() catches up on reconnect
+    link->send(command, json{{"symbols", symbols}}, [](const json*) {});
+}
+
+size_t Aggregator::change_universe(const std::vector<std::string>& symbols, bool add) {
+    std::unordered_map<std::string, std::vector<std::string>> by_owner;
+    size_t changed = 0;
+
+    for (const auto& symbol : symbols) {
+        auto it = owner_.find(symbol);
+        if (add) {
+            if (it != owner_.end()) continue;
+            const std::string& node = ring_.owner(symbol);
+            owner_.emplace(symbol, node);
+            universe_.push_back(symbol);
+            retired_.erase(symbol);
+            by_owner[node].push_back(symbol);
+        } else {
+            if (it == owner_.end()) continue;
+            by_owner[it->second].push_back(symbol);
+            owner_.erase(it);
+            retired_.insert(symbol);
+        }
+        ++changed;
+    }
+
+    if (!add && changed > 0) {
+        universe_.erase(std::remove_if(universe_.begin(), universe_.end(),
+                                       [this](const std::string& s) { return !owner_.count(s); }),
+                        universe_.end());
+    }
+
+    for (const auto& [node, owned] : by_owner) {
+        send_subscriptions(node, add ? "subscribe" : "unsubscribe", owned);
+    }
+    return changed;
+}
+
+bool Aggregator::owns(const std::string& node, const std::string& symbol) const {
+    // Symbols outside the managed universe are leftovers of a removal
+    // (or of an engine's own startup list) and belong to nobody
+    auto it = owner_.find(symbol);
+    return it != owner_.end() && it->second == node;
+}
+
+Aggregator::EngineLink* Aggregator::link_for(const std::string& node) const {
+    for (const auto& link : links_) {
+        if (link->endpoint().id == node) return link.get();
+    }
+    return nullptr;
+}
+
+std::vector<Aggregator::EngineLink*> Aggregator::connected_links() const {
+    std::vector<EngineLink*> connected;
+    for (const auto& link : links_) {
+        if (link->connected()) connected.push_back(link.get());
+    }
+    return connected;
+}
+
+json Aggregator::cluster_state() const {
+    std::unordered_map<std::string, size_t> counts;
+    for (const auto& [symbol, node] : owner_) {
+        counts[node]++;
+    }
+
+    json instances = json::array();
+    for (const auto& link : links_) {
+        const auto& endpoint = link->endpoint();
+        instances.push_back({
+            {"id", endpoint.id},
+            {"host", endpoint.host},
+            {"port", endpoint.port},
+            {"connected", link->connected()},
+            {"in_ring", link->in_ring},
+            {"symbols", counts[endpoint.id]}
+        });
+    }
+
+    return json{
+        {"instances", std::move(instances)},
+        {"universe", universe_.size()},
+        {"unassigned", counts[""]}
+    };
+}
+
+json Aggregator::merge_stats(Results& results) const {
+    std::vector<const json*> all;
+    for (const auto& [node, stats] : results) {
+        all.push_back(&stats);
+    }
+    json merged = merge_stat_objects(all);
+    merged["cluster"] = cluster_state();
+    return merged;
+}
+
+void Aggregator::fan_out(const std::vector<EngineLink*>& targets, const std::string& command,
+                         const json& data, Merge merge, Reply reply) {
+    auto fan = std::make_shared<FanOut>(io_);
+    fan->expected = targets.size();
+    fan->merge = std::move(merge);
+    fan->reply = std::move(reply);
+
+    if (targets.empty()) {
+        fan->finish();
+        return;
+    }
+
+    fan->timer.expires_after(milliseconds(config_.request_timeout_ms));
+    fan->timer.async_wait([fan](const boost::system::error_code& ec) {
+        if (!ec) fan->finish();
+    });
+
+    for (EngineLink* link : targets) {
+        link->send(command, data, [fan, node = link->endpoint().id](const json* result) {
+            if (fan->finished) return;
+            if (result) {
+                fan->results.emplace_back(node, *result);
+            }
+            if (++fan->received == fan->expected) {
+                fan->finish();
+            }
+        });
+    }
+}
+
+void Aggregator::route(const std::string& symbol, const std::string& command,
+                       const json& data, Reply reply) {
+    auto it = owner_.find(symbol);
+    const std::string& node = it != owner_.end() ? it->second : ring_.owner(symbol);
+    EngineLink* link = link_for(node);
+
+    if (!link || !link->connected()) {
+        reply(json{{"error", "No live instance owns " + symbol}});
+        return;
+    }
+
+    fan_out({link}, command, data, [symbol](Results& results) {
+        return results.empty() ? json{{"error", "Timed out waiting for " + symbol}}
+                               : std::move(results.front().second);
+    }, std::move(reply));
+}
+
+void Aggregator::handle_request(const std::shared_ptr<ClientSession>& session,
+                                const json& request) {
+    json id = request.value("id", json());
+    std::string command = string_or(request, "command", "");
+    json data = request.value("data", json::object());
+    if (command.empty()) {
+        throw std::invalid_argument("command must be a non-empty string");
+    }
+    if (!data.is_object()) {
+        throw std::invalid_argument("data must be an object");
+    }
+
+    Reply reply = [session, id](json result) {
+        session->send(response_line(id, std::move(result)));
+    };
+
+    if (command == "get_active_stocks") {
+        // Leaderboard: owners' entries only, biggest movers first
+        fan_out(connected_links(), command, data, [this](Results& results) {
+            json rows = json::array();
+            std::unordered_set<std::string> seen;
+            for (auto& [node, list] : results) {
+                if (!list.is_array()) continue;
+                for (auto& row : list) {
+                    std::string symbol = string_or(row, "symbol", "");
+                    if (owns(node, symbol) && seen.insert(symbol).second) {
+                        mark_partition_context(row, node);
+                        rows.push_back(std::move(row));
+                    }
+                }
+            }
+            std::stable_sort(rows.begin(), rows.end(), [](const json& a, const json& b) {
+                return number_or(a, "change_percent", 0.0) > number_or(b, "change_percent", 0.0);
+            });
+            return rows;
+        }, std::move(reply));
+
+    } else if (command == "get_stats") {
+        fan_out(connected_links(), command, data,
+                [this](Results& results) { return merge_stats(results); }, std::move(reply));
+
+    } else if (command == "screen") {
+        std::string sort = string_or(data, "sort", "change");
+        bool descending = string_or(data, "order", "desc") != "asc";
+        size_t limit = limit_of(data, 100);
+
+        fan_out(connected_links(), command, data,
+                [this, sort, descending, limit](Results& results) {
+            json rows = json::array();
+            std::unordered_set<std::string> seen;
+            double matched = 0, scanned = 0, query_time_us = 0;
+            uint64_t timestamp = 0;
+            for (auto& [node, result] : results) {
+                if (!result.is_object()) continue;
+                query_time_us = std::max(query_time_us, number_or(result, "query_time_us", 0.0));
+                // Oldest instance snapshot bounds the merged result's age
+                uint64_t ts = timestamp_of(result);
+                if (ts > 0 && (timestamp == 0 || ts < timestamp)) timestamp = ts;
+                // Engines evict symbols on unsubscribe; rows a previous owner
+                // returns before it gets there are dropped and not counted
+                double foreign = 0;
+                auto list = result.find("rows");
+                if (list != result.end() && list->is_array()) {
+                    for (auto& row : *list) {
+                        std::string symbol = string_or(row, "symbol", "");
+                        if (owns(node, symbol) && seen.insert(symbol).second) {
+                            rows.push_back(std::move(row));
+                        } else {
+                            foreign++;
+                        }
+                    }
+                }
+                matched += std::max(number_or(result, "matched", 0.0) - foreign, 0.0);
+                scanned += std::max(number_or(result, "scanned", 0.0) - foreign, 0.0);
+            }
+            std::stable_sort(rows.begin(), rows.end(), [&](const json& a, const json& b) {
+                double x = number_or(a, sort.c_str(), 0.0);
+                double y = number_or(b, sort.c_str(), 0.0);
+                return descending ? x > y : x < y;
+            });
+            if (rows.size() > limit) {
+                rows.erase(rows.begin() + static_cast<std::ptrdiff_t>(limit), rows.end());
+            }
+            return json{
+                {"rows", std::move(rows)},
+                {"matched", static_cast<uint64_t>(matched)},
+                {"scanned", static_cast<uint64_t>(scanned)},
+                {"timestamp", timestamp},
+                {"query_time_us", query_time_us},
+                // Each row's zscore is against its owner's sector moments
+                {"zscore_scope", "partition"}
+            };
+        }, std::move(reply));
+
+    } else if (command == "query_journal") {
+        // A symbol's history may sit on earlier owners, so ask everyone
+        size_t limit = limit_of(data, 1000);
+        fan_out(connected_links(), command, data, [limit](Results& results) {
+            json records = json::array();
+            for (auto& [node, list] : results) {
+                if (!list.is_array()) continue;
+                for (auto& record : list) {
+                    records.push_back(std::move(record));
+                }
+            }
+            std::stable_sort(records.begin(), records.end(), [](const json& a, const json& b) {
+                return timestamp_of(a) < timestamp_of(b);
+            });
+            if (records.size() > limit) {
+                records.erase(records.begin(),
+                              records.begin() + static_cast<std::ptrdiff_t>(records.size() - limit));
+            }
+            return records;
+        }, std::move(reply));
+
+    } else if (command == "get_stock_data" || command == "get_history") {
+        std::string symbol = string_or(data, "symbol", "");
+        if (symbol.empty()) {
+            throw std::invalid_argument(command + " needs a symbol");
+        }
+        route(symbol, command, data, std::move(reply));
+
+    } else if (command == "subscribe" || command == "unsubscribe") {
+        std::vector<std::string> symbols;
+        if (data.contains("symbols") && data["symbols"].is_array()) {
+            for (const auto& symbol : data["symbols"]) {
+                if (symbol.is_string()) symbols.push_back(symbol.get<std::string>());
+            }
+        }
+        size_t changed = change_universe(symbols, command == "subscribe");
+        reply(json{{"changed", changed}, {"symbols", universe_.size()}});
+
+    } else if (command == "get_cluster") {
+        reply(cluster_state());
+
+    } else {
+        // Anything else (e.g. dump_trace) goes to every instance;
+        // the reply is keyed by instance id
+        fan_out(connected_links(), command, data, [](Results& results) {
+            json by_instance = json::object();
+            for (auto& [node, result] : results) {
+                by_instance[node] = std::move(result);
+            }
+            return by_instance;
+        }, std::move(reply));
+    }
+}
+
+void Aggregator::schedule_stats() {
+    stats_timer_.expires_after(milliseconds(config_.stats_interval_ms));
+    stats_timer_.async_wait([this](const boost::system::error_code& ec) {
+        if (ec || !running_) return;
+
+        if (!sessions_.empty()) {
+            fan_out(connected_links(), "get_stats", json::object(),
+                    [this](Results& results) { return merge_stats(results); },
+                    [this](json merged) {
+                broadcast(json{{"type", "stats"}, {"data", std::move(merged)}}.dump() + "\n");
+            });
+        }
+        schedule_stats();
+    });
+}
+
+void Aggregator::broadcast(const std::string& line) {
+    // Copy: a send can drop a stalled client from sessions_
+    auto sessions = std::vector<std::shared_ptr<ClientSession>>(sessions_.begin(), sessions_.end());
+    for (const auto& session : sessions) {
+        session->send(line);
+    }
+}
+
+} // namespace stock_monitor
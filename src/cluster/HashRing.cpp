@@ -0,0 +1,101 @@
+#include "cluster/HashRing.h"
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace stock_monitor {
+
+HashRing::HashRing(size_t virtual_nodes)
+    : virtual_nodes_(std::max<size_t>(virtual_nodes, 1)) {
+}
+
+uint64_t HashRing::hash(std::string_view key) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (unsigned char c : key) {
+        h ^= c;
+        h *= 0x100000001b3ULL;
+    }
+
+    // FNV alone clusters short, similar keys such as tickers
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+void HashRing::add_node(const std::string& node) {
+    if (contains(node)) return;
+    nodes_.insert(std::lower_bound(nodes_.begin(), nodes_.end(), node), node);
+    rebuild();
+}
+
+void HashRing::remove_node(const std::string& node) {
+    auto it = std::lower_bound(nodes_.begin(), nodes_.end(), node);
+    if (it == nodes_.end() || *it != node) return;
+    nodes_.erase(it);
+    rebuild();
+}
+
+bool HashRing::contains(const std::string& node) const {
+    return std::binary_search(nodes_.begin(), nodes_.end(), node);
+}
+
+void HashRing::rebuild() {
+    points_.clear();
+    points_.reserve(nodes_.size() * virtual_nodes_);
+    for (uint32_t n = 0; n < nodes_.size(); ++n) {
+        for (size_t v = 0; v < virtual_nodes_; ++v) {
+            points_.emplace_back(hash(nodes_[n] + "#" + std::to_string(v)), n);
+        }
+    }
+    // Ties broken by node index, which follows the sorted node names
+    std::sort(points_.begin(), points_.end());
+}
+
+const std::string& HashRing::owner(std::string_view key) const {
+    static const std::string none;
+    if (points_.empty()) return none;
+
+    auto it = std::lower_bound(points_.begin(), points_.end(),
+                               std::make_pair(hash(key), uint32_t{0}));
+    if (it == points_.end()) {
+        it = points_.begin();
+    }
+    return nodes_[it->second];
+}
+
+std::vector<std::string> HashRing::slice(const std::string& node,
+                                         const std::vector<std::string>& keys) const {
+    std::vector<std::string> owned;
+    for (const auto& key : keys) {
+        if (owner(key) == node) {
+            owned.push_back(key);
+        }
+    }
+    return owned;
+}
+
+std::vector<std::string> load_symbol_list(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Cannot open symbol list " + path);
+    }
+
+    std::vector<std::string> symbols;
+    std::string line;
+    while (std::getline(file, line)) {
+        auto hash_pos = line.find('#');
+        if (hash_pos != std::string::npos) {
+            line.erase(hash_pos);
+        }
+        auto begin = line.find_first_not_of(" \t\r");
+        if (begin == std::string::npos) continue;
+        auto end = line.find_last_not_of(" \t\r");
+        symbols.push_back(line.substr(begin, end - begin + 1));
+    }
+    return symbols;
+}
+
+} // namespace stock_monitor
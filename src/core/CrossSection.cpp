@@ -0,0 +1,266 @@
+#include "core/CrossSection.h"
+#include "core/StockMonitor.h"
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <nlohmann/json.hpp>
+
+namespace stock_monitor {
+
+using namespace std::chrono;
+
+namespace {
+
+std::string trim(const std::string& s) {
+    auto begin = s.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return "";
+    auto end = s.find_last_not_of(" \t\r");
+    return s.substr(begin, end - begin + 1);
+}
+
+void finalize_group(GroupAggregate& group, double sum, double sum_sq) {
+    if (group.count == 0) return;
+    group.avg_change = sum / group.count;
+    double variance = sum_sq / group.count - group.avg_change * group.avg_change;
+    group.stddev_change = std::sqrt(std::max(variance, 0.0));
+}
+
+double zscore(double value, double mean, double stddev) {
+    return stddev > 0.0 ? (value - mean) / stddev : 0.0;
+}
+
+} // namespace
+
+void to_json(nlohmann::json& j, const GroupAggregate& group) {
+    j = nlohmann::json{
+        {"name", group.name},
+        {"count", group.count},
+        {"advancing", group.advancing},
+        {"avg_change", group.avg_change},
+        {"stddev_change", group.stddev_change}
+    };
+}
+
+void to_json(nlohmann::json& j, const MarketContext& context) {
+    j = nlohmann::json{
+        {"sector", context.sector},
+        {"advancing_pct", context.advancing_pct},
+        {"sector_avg_change", context.sector_avg_change},
+        {"sector_zscore", context.sector_zscore},
+        {"market_zscore", context.market_zscore},
+        {"sector_rank", context.sector_rank},
+        {"sector_size", context.sector_size},
+        {"index_rank", context.index_rank},
+        {"index_size", context.index_size}
+    };
+}
+
+SectorMap SectorMap::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Cannot open sector map: " + path);
+    }
+
+    SectorMap map;
+    std::string line;
+    while (std::getline(file, line)) {
+        line = trim(line);
+        if (line.empty() || line[0] == '#') continue;
+
+        std::stringstream ss(line);
+        std::string symbol, sector, index;
+        std::getline(ss, symbol, ',');
+        std::getline(ss, sector, ',');
+        std::getline(ss, index, ',');
+
+        symbol = trim(symbol);
+        sector = trim(sector);
+        index = trim(index);
+        if (symbol.empty() || sector.empty()) continue;
+
+        map.entries_[symbol] = Entry{
+            intern(map.sectors_, sector),
+            index.empty() ? -1 : intern(map.indexes_, index)
+        };
+    }
+
+    return map;
+}
+
+int32_t SectorMap::intern(std::vector<std::string>& names, const std::string& name) {
+    auto it = std::find(names.begin(), names.end(), name);
+    if (it != names.end()) {
+        return static_cast<int32_t>(it - names.begin());
+    }
+    names.push_back(name);
+    return static_cast<int32_t>(names.size() - 1);
+}
+
+int32_t SectorMap::sector_id(const std::string& symbol) const {
+    auto it = entries_.find(symbol);
+    return it != entries_.end() ? it->second.sector : -1;
+}
+
+int32_t SectorMap::index_id(const std::string& symbol) const {
+    auto it = entries_.find(symbol);
+    return it != entries_.end() ? it->second.index : -1;
+}
+
+const std::string& SectorMap::sector_name(int32_t id) const {
+    static const std::string unknown;
+    return (id >= 0 && static_cast<size_t>(id) < sectors_.size()) ? sectors_[id] : unknown;
+}
+
+const std::string& SectorMap::index_name(int32_t id) const {
+    static const std::string unknown;
+    return (id >= 0 && static_cast<size_t>(id) < indexes_.size()) ? indexes_[id] : unknown;
+}
+
+void CrossSectionColumns::clear() {
+    current.clear();
+    min.clear();
+    max.clear();
+    open.clear();
+    sector_id.clear();
+    index_id.clear();
+}
+
+void CrossSectionColumns::reserve(size_t n) {
+    current.reserve(n);
+    min.reserve(n);
+    max.reserve(n);
+    open.reserve(n);
+    sector_id.reserve(n);
+    index_id.reserve(n);
+}
+
+void CrossSectionCalculator::compute(const CrossSectionColumns& columns,
+                                     const SectorMap& sector_map,
+                                     CrossSectionResult& out) {
+    auto start_time = high_resolution_clock::now();
+    size_t n = columns.size();
+
+    out.timestamp = duration_cast<milliseconds>(
+        system_clock::now().time_since_epoch()).count();
+    out.symbols = n;
+    out.sector_id = columns.sector_id;
+    out.index_id = columns.index_id;
+
+    // Change vs window low, same definition as the alert threshold
+    PriceCalculator::batch_calculate_changes(columns.current, columns.min, out.change);
+
+    out.advancing = PriceCalculator::count_greater_avx2(
+        columns.current.data(), columns.open.data(), n);
+    out.advancing_pct = n > 0 ? (100.0 * out.advancing) / n : 0.0;
+
+    double sum = 0.0, sum_sq = 0.0;
+    PriceCalculator::sum_and_squares_avx2(out.change.data(), n, sum, sum_sq);
+    GroupAggregate market;
+    market.count = static_cast<uint32_t>(n);
+    finalize_group(market, sum, sum_sq);
+    out.avg_change = market.avg_change;
+    out.stddev_change = market.stddev_change;
+
+    // Group accumulation is a scatter, which AVX2 cannot do; it is a
+    // single pass of adds over contiguous columns
+    size_t sector_count = sector_map.sector_count();
+    size_t index_count = sector_map.index_count();
+    out.sectors.assign(sector_count, GroupAggregate{});
+    out.indexes.assign(index_count, GroupAggregate{});
+    std::vector<double> sector_sum(sector_count, 0.0), sector_sq(sector_count, 0.0);
+    std::vector<double> index_sum(index_count, 0.0), index_sq(index_count, 0.0);
+
+    for (size_t i = 0; i < n; ++i) {
+        double change = out.change[i];
+        uint32_t advancing = columns.current[i] > columns.open[i] ? 1 : 0;
+
+        int32_t s = columns.sector_id[i];
+        if (s >= 0) {
+            auto& group = out.sectors[s];
+            group.count++;
+            group.advancing += advancing;
+            sector_sum[s] += change;
+            sector_sq[s] += change * change;
+        }
+
+        int32_t x = columns.index_id[i];
+        if (x >= 0) {
+            auto& group = out.indexes[x];
+            group.count++;
+            group.advancing += advancing;
+            index_sum[x] += change;
+            index_sq[x] += change * change;
+        }
+    }
+
+    // Slot 0 holds the market-wide moments for unmapped symbols
+    auto& means = out.zscore_means;
+    auto& inv_stddevs = out.zscore_inv_stddevs;
+    means.assign(sector_count + 1, 0.0);
+    inv_stddevs.assign(sector_count + 1, 0.0);
+    means[0] = market.avg_change;
+    inv_stddevs[0] = market.stddev_change > 0.0 ? 1.0 / market.stddev_change : 0.0;
+
+    for (size_t s = 0; s < sector_count; ++s) {
+        out.sectors[s].name = sector_map.sector_name(static_cast<int32_t>(s));
+        finalize_group(out.sectors[s], sector_sum[s], sector_sq[s]);
+        means[s + 1] = out.sectors[s].avg_change;
+        inv_stddevs[s + 1] = out.sectors[s].stddev_change > 0.0 ?
+            1.0 / out.sectors[s].stddev_change : 0.0;
+    }
+
+    for (size_t x = 0; x < index_count; ++x) {
+        out.indexes[x].name = sector_map.index_name(static_cast<int32_t>(x));
+        finalize_group(out.indexes[x], index_sum[x], index_sq[x]);
+    }
+
+    out.compute_time_ns = duration_cast<nanoseconds>(
+        high_resolution_clock::now() - start_time).count();
+}
+
+MarketContext CrossSectionCalculator::context_for(const CrossSectionResult& result,
+                                                  const SectorMap& sector_map,
+                                                  double change_percent,
+                                                  int32_t sector_id,
+                                                  int32_t index_id) {
+    MarketContext context;
+    size_t n = result.change.size();
+    if (n == 0) return context;
+
+    context.advancing_pct = result.advancing_pct;
+    context.market_zscore = zscore(change_percent, result.avg_change, result.stddev_change);
+
+    if (sector_id >= 0 && static_cast<size_t>(sector_id) < result.sectors.size()) {
+        const auto& sector = result.sectors[sector_id];
+        context.sector = sector_map.sector_name(sector_id);
+        context.sector_avg_change = sector.avg_change;
+        context.sector_zscore = zscore(change_percent, sector.avg_change, sector.stddev_change);
+        context.sector_size = sector.count;
+        context.sector_rank = 1 + static_cast<uint32_t>(
+            PriceCalculator::count_above_in_group_avx2(
+                result.change.data(), result.sector_id.data(), n, sector_id, change_percent));
+    }
+
+    if (index_id >= 0 && static_cast<size_t>(index_id) < result.indexes.size()) {
+        context.index_size = result.indexes[index_id].count;
+        context.index_rank = 1 + static_cast<uint32_t>(
+            PriceCalculator::count_above_in_group_avx2(
+                result.change.data(), result.index_id.data(), n, index_id, change_percent));
+    } else {
+        context.index_size = static_cast<uint32_t>(n);
+        context.index_rank = 1 + static_cast<uint32_t>(
+            PriceCalculator::count_above_in_group_avx2(
+                result.change.data(), nullptr, n, -1, change_percent));
+    }
+
+    // The snapshot can lag the live change by up to one interval
+    context.sector_rank = std::min(context.sector_rank, context.sector_size);
+    context.index_rank = std::min(context.index_rank, context.index_size);
+
+    return context;
+}
+
+} // namespace stock_monitor
@@ -0,0 +1,269 @@
+#include "core/IngestPipeline.h"
+#include "utils/ThreadFactory.h"
+#include "utils/FlightRecorder.h"
+#include <chrono>
+#include <algorithm>
+#include <unordered_map>
+
+namespace stock_monitor {
+
+using namespace std::chrono;
+
+namespace {
+
+uint64_t now_ns() {
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+constexpr size_t kNone = static_cast<size_t>(-1);
+
+} // namespace
+
+IngestPipeline::Arrival IngestPipeline::Arrival::now() {
+    return Arrival{FlightRecorder::now(), now_ns()};
+}
+
+struct IngestPipeline::ShardScratch {
+    // Batch indices of the messages that survive conflation for a symbol
+    struct Group {
+        size_t min_trade = kNone;
+        size_t max_trade = kNone;
+        size_t last_trade = kNone;
+        size_t min_quote = kNone;
+        size_t max_quote = kNone;
+        size_t last_quote = kNone;
+        uint64_t volume = 0;
+    };
+
+    // Batch indices of the low, high and last of one message kind
+    static void track(const std::vector<Message>& batch, size_t i,
+                      size_t& min, size_t& max, size_t& last) {
+        track_low(batch, i, min);
+        if (max == kNone || batch[i].trade.price > batch[max].trade.price) max = i;
+        last = i;
+    }
+
+    // Shed updates only compete for the low
+    static void track_low(const std::vector<Message>& batch, size_t i, size_t& min) {
+        if (min == kNone || batch[i].trade.price < batch[min].trade.price) min = i;
+    }
+
+    // Queues low, high and last without repeats; returns the volume of
+    // the ones queued besides last
+    static uint64_t emit_extremes(const std::vector<Message>& batch, std::vector<size_t>& emit,
+                                  size_t min, size_t max, size_t last) {
+        uint64_t volume = 0;
+        if (min != last) {
+            emit.push_back(min);
+            volume += batch[min].trade.volume;
+        }
+        if (max != last && max != min) {
+            emit.push_back(max);
+            volume += batch[max].trade.volume;
+        }
+        emit.push_back(last);
+        return volume;
+    }
+
+    struct Priority {
+        double entry_price = 0.0;
+        uint64_t checked_ns = 0;
+    };
+
+    std::vector<Message> batch;
+    std::unordered_map<std::string, Group> groups;
+    std::vector<size_t> emit;
+    std::vector<uint8_t> shed_mask;  // Per batch index
+    std::unordered_map<std::string, Priority> priorities;
+};
+
+IngestPipeline::IngestPipeline(const Config& config, Sink sink, EntryPriceFn entry_price)
+    : config_(config)
+    , sink_(std::move(sink))
+    , entry_price_(std::move(entry_price)) {
+    size_t shard_count = std::max<size_t>(config_.shards, 1);
+    shards_.reserve(shard_count);
+    for (size_t i = 0; i < shard_count; ++i) {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+
+    for (size_t i = 0; i < shard_count; ++i) {
+        Shard& shard = *shards_[i];
+        shard.thread = ThreadFactory::spawn(ThreadRole::Ingest, "sm-ingest-" + std::to_string(i),
+                                            [this, &shard] { run_shard(shard); }, i);
+    }
+}
+
+IngestPipeline::~IngestPipeline() {
+    running_ = false;
+    for (auto& shard : shards_) {
+        if (shard->thread.joinable()) {
+            shard->thread.join();
+        }
+    }
+}
+
+void IngestPipeline::submit(const TradeData& trade, double spread_percent) {
+    // Same symbol always lands on the same shard, preserving its order
+    size_t index = std::hash<std::string>{}(trade.symbol) % shards_.size();
+    Shard& shard = *shards_[index];
+
+    {
+        std::lock_guard lock(shard.mutex);
+        shard.queue.push_back(Message{trade, spread_percent, Arrival::now()});
+    }
+    shard.depth.fetch_add(1, std::memory_order_relaxed);
+    received_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void IngestPipeline::run_shard(Shard& shard) {
+    ShardScratch scratch;
+    std::deque<Message> drained;
+    auto idle = ThreadFactory::idle_strategy(ThreadRole::Ingest);
+
+    while (running_) {
+        {
+            std::lock_guard lock(shard.mutex);
+            drained.swap(shard.queue);
+        }
+
+        if (drained.empty()) {
+            shard.lag_ns.store(0, std::memory_order_relaxed);
+            idle.idle();
+            continue;
+        }
+        idle.reset();
+
+        uint64_t lag_ns = now_ns() - drained.front().arrival.steady_ns;
+        shard.lag_ns.store(lag_ns, std::memory_order_relaxed);
+        uint64_t prev_max = max_lag_ns_.load(std::memory_order_relaxed);
+        while (lag_ns > prev_max &&
+               !max_lag_ns_.compare_exchange_weak(prev_max, lag_ns, std::memory_order_relaxed)) {
+        }
+
+        size_t count = drained.size();
+        scratch.batch.assign(std::make_move_iterator(drained.begin()),
+                             std::make_move_iterator(drained.end()));
+        drained.clear();
+
+        process_batch(scratch.batch, lag_ns, scratch);
+
+        shard.depth.fetch_sub(count, std::memory_order_relaxed);
+    }
+}
+
+void IngestPipeline::process_batch(std::vector<Message>& batch, uint64_t lag_ns,
+                                   ShardScratch& scratch) {
+    if (lag_ns <= config_.conflate_lag_us * 1000) {
+        for (const auto& message : batch) {
+            sink_(message.trade, message.spread_percent, message.arrival);
+        }
+        processed_.fetch_add(batch.size(), std::memory_order_relaxed);
+        return;
+    }
+
+    // Kept fraction of the entry price: 1 - shed_keep_pct at shed_lag_us,
+    // approaching 1 (only prints at or above entry) as lag keeps growing
+    uint64_t shed_lag_ns = config_.shed_lag_us * 1000;
+    bool shed = entry_price_ && lag_ns > shed_lag_ns;
+    double keep_ratio = shed
+        ? 1.0 - config_.shed_keep_pct / 100.0 * static_cast<double>(shed_lag_ns) / lag_ns
+        : 0.0;
+
+    uint64_t now = now_ns();
+    uint64_t refresh_ns = config_.priority_refresh_ms * 1000000;
+    auto& groups = scratch.groups;
+    groups.clear();
+    auto& shed_mask = scratch.shed_mask;
+    shed_mask.assign(batch.size(), 0);
+
+    for (size_t i = 0; i < batch.size(); ++i) {
+        const auto& message = batch[i];
+
+        bool dropped = false;
+        if (shed) {
+            auto& priority = scratch.priorities[message.trade.symbol];
+            if (priority.checked_ns == 0 || now - priority.checked_ns > refresh_ns) {
+                priority.entry_price = entry_price_(message.trade.symbol);
+                priority.checked_ns = now;
+            }
+            dropped = message.trade.price < priority.entry_price * keep_ratio;
+            shed_mask[i] = dropped;
+        }
+
+        // Quote mids land in the same price window as trades, so both
+        // keep their low, high and last. A shed update still competes for
+        // the low (a new low moves the entry price), and a shed trade's
+        // volume still counts.
+        auto& group = groups[message.trade.symbol];
+        bool quote = message.spread_percent >= 0.0;
+        size_t& min = quote ? group.min_quote : group.min_trade;
+        if (dropped) {
+            ShardScratch::track_low(batch, i, min);
+        } else if (quote) {
+            ShardScratch::track(batch, i, min, group.max_quote, group.last_quote);
+        } else {
+            ShardScratch::track(batch, i, min, group.max_trade, group.last_trade);
+        }
+        if (!quote) {
+            group.volume += message.trade.volume;
+        }
+    }
+
+    // Re-emit survivors in arrival order; the last print carries the volume
+    // of every collapsed or shed trade so session volume stays exact, and
+    // the last quote sorts after its low/high so its spread is the one
+    // that sticks. A symbol whose updates were all shed emits just its low.
+    auto& emit = scratch.emit;
+    emit.clear();
+    for (auto& [symbol, group] : groups) {
+        if (group.min_trade != kNone) {
+            size_t last = group.last_trade != kNone ? group.last_trade : group.min_trade;
+            size_t max = group.max_trade != kNone ? group.max_trade : last;
+            uint64_t kept_volume = ShardScratch::emit_extremes(
+                batch, emit, group.min_trade, max, last);
+            batch[last].trade.volume = group.volume - kept_volume;
+        }
+        if (group.min_quote != kNone) {
+            size_t last = group.last_quote != kNone ? group.last_quote : group.min_quote;
+            size_t max = group.max_quote != kNone ? group.max_quote : last;
+            ShardScratch::emit_extremes(batch, emit, group.min_quote, max, last);
+        }
+    }
+    std::sort(emit.begin(), emit.end());
+
+    uint64_t shed_count = 0;
+    for (uint8_t dropped : shed_mask) {
+        shed_count += dropped;
+    }
+    for (size_t index : emit) {
+        shed_count -= shed_mask[index];  // Kept as its symbol's low
+        sink_(batch[index].trade, batch[index].spread_percent, batch[index].arrival);
+    }
+
+    processed_.fetch_add(emit.size(), std::memory_order_relaxed);
+    shed_.fetch_add(shed_count, std::memory_order_relaxed);
+    conflated_.fetch_add(batch.size() - emit.size() - shed_count, std::memory_order_relaxed);
+}
+
+IngestPipeline::Stats IngestPipeline::get_stats() const {
+    Stats stats;
+    stats.received = received_.load(std::memory_order_relaxed);
+    stats.processed = processed_.load(std::memory_order_relaxed);
+    stats.conflated = conflated_.load(std::memory_order_relaxed);
+    stats.shed = shed_.load(std::memory_order_relaxed);
+
+    uint64_t depth = 0, lag_ns = 0;
+    for (const auto& shard : shards_) {
+        depth += shard->depth.load(std::memory_order_relaxed);
+        lag_ns = std::max(lag_ns, shard->lag_ns.load(std::memory_order_relaxed));
+    }
+
+    stats.queue_depth = depth;
+    stats.lag_us = lag_ns / 1000.0;
+    stats.max_lag_us = max_lag_ns_.exchange(0, std::memory_order_relaxed) / 1000.0;
+    stats.overloaded = lag_ns > config_.conflate_lag_us * 1000;
+    return stats;
+}
+
+} // namespace stock_monitor
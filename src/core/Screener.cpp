@@ -0,0 +1,243 @@
+#include "core/Screener.h"
+#include <chrono>
+#include <mutex>
+#include <algorithm>
+#include <stdexcept>
+#include <immintrin.h>
+#include <nlohmann/json.hpp>
+
+namespace stock_monitor {
+
+using namespace std::chrono;
+
+namespace {
+
+constexpr const char* kFieldNames[kScreenFieldCount] = {
+    "price", "change", "volume", "spread", "min", "max", "zscore"
+};
+
+ScreenField parse_field(const std::string& name) {
+    for (size_t i = 0; i < kScreenFieldCount; ++i) {
+        if (name == kFieldNames[i]) {
+            return static_cast<ScreenField>(i);
+        }
+    }
+    throw std::invalid_argument("Unknown screen field: " + name);
+}
+
+ScreenOp parse_op(const std::string& op) {
+    if (op == "<") return ScreenOp::Less;
+    if (op == "<=") return ScreenOp::LessEqual;
+    if (op == ">") return ScreenOp::Greater;
+    if (op == ">=") return ScreenOp::GreaterEqual;
+    if (op == "between") return ScreenOp::Between;
+    throw std::invalid_argument("Unknown screen operator: " + op);
+}
+
+bool matches(double v, const ScreenPredicate& p) {
+    switch (p.op) {
+        case ScreenOp::Less:         return v < p.value;
+        case ScreenOp::LessEqual:    return v <= p.value;
+        case ScreenOp::Greater:      return v > p.value;
+        case ScreenOp::GreaterEqual: return v >= p.value;
+        case ScreenOp::Between:      return v >= p.value && v <= p.upper;
+    }
+    return false;
+}
+
+template<ScreenOp Op>
+__m256d compare(__m256d v, __m256d lo, __m256d hi) {
+    if constexpr (Op == ScreenOp::Less) return _mm256_cmp_pd(v, lo, _CMP_LT_OQ);
+    if constexpr (Op == ScreenOp::LessEqual) return _mm256_cmp_pd(v, lo, _CMP_LE_OQ);
+    if constexpr (Op == ScreenOp::Greater) return _mm256_cmp_pd(v, lo, _CMP_GT_OQ);
+    if constexpr (Op == ScreenOp::GreaterEqual) return _mm256_cmp_pd(v, lo, _CMP_GE_OQ);
+    if constexpr (Op == ScreenOp::Between) {
+        return _mm256_and_pd(_mm256_cmp_pd(v, lo, _CMP_GE_OQ),
+                             _mm256_cmp_pd(v, hi, _CMP_LE_OQ));
+    }
+}
+
+template<ScreenOp Op>
+void filter_words(const double* values, size_t count,
+                  const ScreenPredicate& predicate, uint64_t* mask) {
+    const __m256d lo = _mm256_set1_pd(predicate.value);
+    const __m256d hi = _mm256_set1_pd(predicate.upper);
+    size_t words = (count + 63) / 64;
+
+    for (size_t w = 0; w < words; ++w) {
+        // Rows already rejected by an earlier predicate are skipped
+        if (mask[w] == 0) continue;
+
+        size_t base = w * 64;
+        size_t end = std::min(base + 64, count);
+        uint64_t bits = 0;
+
+        size_t i = base;
+        for (; i + 3 < end; i += 4) {
+            __m256d v = _mm256_loadu_pd(&values[i]);
+            uint64_t lanes = static_cast<uint64_t>(
+                _mm256_movemask_pd(compare<Op>(v, lo, hi)));
+            bits |= lanes << (i - base);
+        }
+        for (; i < end; ++i) {
+            if (matches(values[i], predicate)) {
+                bits |= 1ULL << (i - base);
+            }
+        }
+
+        mask[w] &= bits;
+    }
+}
+
+} // namespace
+
+ScreenQuery ScreenQuery::from_json(const nlohmann::json& j) {
+    ScreenQuery query;
+
+    if (j.contains("where")) {
+        for (const auto& clause : j.at("where")) {
+            ScreenPredicate predicate{
+                parse_field(clause.at("field").get<std::string>()),
+                parse_op(clause.at("op").get<std::string>()),
+                0.0
+            };
+            const auto& value = clause.at("value");
+            if (predicate.op == ScreenOp::Between) {
+                if (!value.is_array() || value.size() != 2) {
+                    throw std::invalid_argument("between expects [low, high]");
+                }
+                predicate.value = value[0].get<double>();
+                predicate.upper = value[1].get<double>();
+            } else {
+                predicate.value = value.get<double>();
+            }
+            query.predicates.push_back(predicate);
+        }
+    }
+
+    if (j.contains("sort")) {
+        query.sort_field = parse_field(j.at("sort").get<std::string>());
+    }
+    if (j.contains("order")) {
+        query.descending = j.at("order").get<std::string>() != "asc";
+    }
+    if (j.contains("limit")) {
+        query.limit = j.at("limit").get<size_t>();
+    }
+
+    return query;
+}
+
+void to_json(nlohmann::json& j, const ScreenResult& result) {
+    auto rows = nlohmann::json::array();
+    for (const auto& row : result.rows) {
+        nlohmann::json entry{{"symbol", row.symbol}};
+        for (size_t i = 0; i < kScreenFieldCount; ++i) {
+            entry[kFieldNames[i]] = row.values[i];
+        }
+        rows.push_back(std::move(entry));
+    }
+
+    j = nlohmann::json{
+        {"rows", std::move(rows)},
+        {"matched", result.matched},
+        {"scanned", result.scanned},
+        {"timestamp", result.snapshot_timestamp},
+        {"query_time_us", result.query_time_ns / 1000.0}
+    };
+}
+
+void Screener::publish(std::shared_ptr<const ScreenerSnapshot> snapshot) {
+    std::unique_lock lock(mutex_);
+    snapshot_ = std::move(snapshot);
+}
+
+std::shared_ptr<const ScreenerSnapshot> Screener::snapshot() const {
+    std::shared_lock lock(mutex_);
+    return snapshot_;
+}
+
+ScreenResult Screener::run(const ScreenQuery& query) const {
+    auto start_time = high_resolution_clock::now();
+    ScreenResult result;
+
+    auto snap = snapshot();
+    if (!snap) return result;
+
+    size_t n = snap->symbols.size();
+    result.scanned = n;
+    result.snapshot_timestamp = snap->timestamp;
+
+    // One bit per row; tail bits past n start cleared
+    std::vector<uint64_t> mask((n + 63) / 64, ~0ULL);
+    if (n % 64 != 0) {
+        mask.back() = (1ULL << (n % 64)) - 1;
+    }
+
+    bool spread_filtered = false;
+    for (const auto& predicate : query.predicates) {
+        filter_avx2(snap->column(predicate.field).data(), n, predicate, mask.data());
+        spread_filtered |= predicate.field == ScreenField::Spread;
+    }
+    if (spread_filtered) {
+        // Spread is -1 until a symbol's first quote; such rows never match
+        ScreenPredicate quoted{ScreenField::Spread, ScreenOp::GreaterEqual, 0.0};
+        filter_avx2(snap->column(ScreenField::Spread).data(), n, quoted, mask.data());
+    }
+
+    std::vector<uint32_t> matches;
+    for (size_t w = 0; w < mask.size(); ++w) {
+        uint64_t bits = mask[w];
+        while (bits) {
+            matches.push_back(static_cast<uint32_t>(w * 64 + __builtin_ctzll(bits)));
+            bits &= bits - 1;
+        }
+    }
+    result.matched = matches.size();
+
+    const auto& key = snap->column(query.sort_field);
+    size_t limit = std::min(query.limit, matches.size());
+    auto by_key = [&key, desc = query.descending](uint32_t a, uint32_t b) {
+        return desc ? key[a] > key[b] : key[a] < key[b];
+    };
+    std::partial_sort(matches.begin(), matches.begin() + limit, matches.end(), by_key);
+
+    result.rows.reserve(limit);
+    for (size_t i = 0; i < limit; ++i) {
+        uint32_t row = matches[i];
+        ScreenRow out{snap->symbols[row], {}};
+        for (size_t f = 0; f < kScreenFieldCount; ++f) {
+            out.values[f] = snap->columns[f][row];
+        }
+        result.rows.push_back(std::move(out));
+    }
+
+    result.query_time_ns = duration_cast<nanoseconds>(
+        high_resolution_clock::now() - start_time).count();
+    return result;
+}
+
+void Screener::filter_avx2(const double* values,
+                           size_t count,
+                           const ScreenPredicate& predicate,
+                           uint64_t* mask) {
+    switch (predicate.op) {
+        case ScreenOp::Less:
+            filter_words<ScreenOp::Less>(values, count, predicate, mask);
+            break;
+        case ScreenOp::LessEqual:
+            filter_words<ScreenOp::LessEqual>(values, count, predicate, mask);
+            break;
+        case ScreenOp::Greater:
+            filter_words<ScreenOp::Greater>(values, count, predicate, mask);
+            break;
+        case ScreenOp::GreaterEqual:
+            filter_words<ScreenOp::GreaterEqual>(values, count, predicate, mask);
+            break;
+        case ScreenOp::Between:
+            filter_words<ScreenOp::Between>(values, count, predicate, mask);
+            break;
+    }
+}
+
+} // namespace stock_monitor
@@ -1,8 +1,14 @@
 #include "core/StockMonitor.h"
+#include "utils/ThreadFactory.h"
+#include "utils/FlightRecorder.h"
 #include <chrono>
+#include <mutex>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <stdexcept>
 #include <immintrin.h>
+#include <nlohmann/json.hpp>
 
 namespace stock_monitor {
 
@@ -13,70 +19,162 @@ StockMonitor::StockMonitor(const Config& config)
     // Reserve space for expected number of stocks
     stock_buffers_.reserve(config.max_stocks);
     
+    if (!config_.sector_map_path.empty()) {
+        sector_map_ = SectorMap::load(config_.sector_map_path);
+    }
+    
+    if (!config_.journal_dir.empty()) {
+        AlertJournal::Config journal_config;
+        journal_config.directory = config_.journal_dir;
+        journal_config.retention_days = config_.journal_retention_days;
+        journal_ = std::make_unique<AlertJournal>(journal_config);
+    }
+    
     // Start cleanup thread
-    cleanup_thread_ = std::thread([this] {
+    cleanup_thread_ = ThreadFactory::spawn(ThreadRole::Housekeeping, "sm-cleanup", [this] {
         while (running_) {
             std::this_thread::sleep_for(milliseconds(config_.cleanup_interval_ms));
             cleanup_inactive_stocks();
         }
     });
+    
+    cross_section_thread_ = ThreadFactory::spawn(ThreadRole::Housekeeping, "sm-xsection", [this] {
+        run_cross_section();
+    });
+    
+    screener_thread_ = ThreadFactory::spawn(ThreadRole::Housekeeping, "sm-screener", [this] {
+        run_screener_refresh();
+    });
+    
+    if (config_.ingest_shards > 0) {
+        IngestPipeline::Config ingest_config;
+        ingest_config.shards = config_.ingest_shards;
+        ingest_config.conflate_lag_us = config_.conflate_lag_us;
+        ingest_config.shed_lag_us = config_.shed_lag_us;
+        ingest_config.shed_keep_pct = config_.shed_keep_pct;
+        
+        ingest_ = std::make_unique<IngestPipeline>(
+            ingest_config,
+            [this](const TradeData& trade, double spread_percent,
+                   const IngestPipeline::Arrival& arrival) {
+                process_update(trade, spread_percent, arrival);
+            },
+            [this](const std::string& symbol) {
+                return entry_price(symbol);
+            });
+    }
 }
 
 StockMonitor::~StockMonitor() {
+    ingest_.reset();
     running_ = false;
     if (cleanup_thread_.joinable()) {
         cleanup_thread_.join();
     }
+    if (cross_section_thread_.joinable()) {
+        cross_section_thread_.join();
+    }
+    if (screener_thread_.joinable()) {
+        screener_thread_.join();
+    }
 }
 
 void StockMonitor::process_trade(const TradeData& trade) {
+    if (ingest_) {
+        ingest_->submit(trade, -1.0);
+    } else {
+        process_update(trade, -1.0, IngestPipeline::Arrival::now());
+    }
+}
+
+void StockMonitor::process_update(const TradeData& trade, double spread_percent,
+                                  const IngestPipeline::Arrival& arrival) {
     auto start_time = high_resolution_clock::now();
     
-    // Get or create buffer for this stock
-    StockBuffer* buffer = nullptr;
+    // Get or create buffer for this stock; the reference keeps it alive
+    // if cleanup erases the symbol while this update is in flight
+    std::shared_ptr<StockBuffer> buffer;
     {
         std::shared_lock read_lock(stocks_mutex_);
         auto it = stock_buffers_.find(trade.symbol);
         if (it != stock_buffers_.end()) {
-            buffer = it->second.get();
+            buffer = it->second;
         }
     }
     
     if (!buffer) {
         std::unique_lock write_lock(stocks_mutex_);
+        // Queued before an unsubscribe; must not bring the symbol back
+        if (unsubscribed_.count(trade.symbol) > 0) return;
+        
         // Double-check after acquiring write lock
         auto it = stock_buffers_.find(trade.symbol);
-        if (it == stock_buffers_.end()) {
-            auto new_buffer = std::make_unique<StockBuffer>(config_.buffer_size);
-            buffer = new_buffer.get();
+        auto idle = idle_buffers_.find(trade.symbol);
+        if (it == stock_buffers_.end() && idle != idle_buffers_.end()) {
+            // Back after cleanup: same buffer, so its tick history continues
+            buffer = std::move(idle->second);
+            idle_buffers_.erase(idle);
+            stock_buffers_[trade.symbol] = buffer;
+        } else if (it == stock_buffers_.end()) {
+            auto new_buffer = std::make_shared<StockBuffer>(config_.buffer_size);
+            new_buffer->sector_id = sector_map_.sector_id(trade.symbol);
+            new_buffer->index_id = sector_map_.index_id(trade.symbol);
+            new_buffer->trace_id = FlightRecorder::intern_symbol(trade.symbol);
+            if (config_.history_enabled) {
+                new_buffer->history = std::make_unique<TickHistory>(config_.history_max_blocks);
+            }
+            buffer = new_buffer;
             stock_buffers_[trade.symbol] = std::move(new_buffer);
         } else {
-            buffer = it->second.get();
+            buffer = it->second;
         }
     }
     
+    // Spans the ingest queue wait (near zero when processed synchronously)
+    FlightRecorder::record(TraceEventType::TickReceived, buffer->trace_id,
+                           arrival.tsc, FlightRecorder::now() - arrival.tsc, trade.volume);
+    
     // Add price to buffer
     {
+        PricePoint point{trade.price, trade.timestamp, trade.volume};
+        uint64_t lock_tsc = FlightRecorder::now();
         std::unique_lock buffer_lock(buffer->mutex);
-        buffer->buffer.push(PricePoint{
-            trade.price,
-            trade.timestamp,
-            trade.volume
-        });
+        FlightRecorder::record(TraceEventType::LockWaited, buffer->trace_id,
+                               lock_tsc, FlightRecorder::now() - lock_tsc);
+        buffer->buffer.push(point);
+        if (buffer->history && spread_percent < 0.0) {
+            buffer->history->append(point);
+        }
         buffer->last_update = duration_cast<milliseconds>(
             system_clock::now().time_since_epoch()).count();
         buffer->last_price = trade.price;
     }
     
+    if (spread_percent >= 0.0) {
+        buffer->spread_percent.store(spread_percent, std::memory_order_relaxed);
+    } else {
+        buffer->session_volume.fetch_add(trade.volume, std::memory_order_relaxed);
+    }
+    
     // Analyze buffer using SIMD
-    double change_percent, min_price, max_price, current_price;
+    double change_percent, min_price, max_price, current_price, open_price;
+    bool analyzed = false;
     bool in_threshold = false;
     
     {
         std::shared_lock buffer_lock(buffer->mutex);
-        if (analyze_buffer_simd(*buffer, change_percent, min_price, max_price, current_price)) {
+        uint64_t analyze_tsc = FlightRecorder::now();
+        bool ok = analyze_buffer_simd(*buffer, change_percent, min_price, max_price,
+                                      current_price, open_price);
+        FlightRecorder::record(TraceEventType::Analyzed, buffer->trace_id,
+                               analyze_tsc, FlightRecorder::now() - analyze_tsc);
+        if (ok) {
+            analyzed = true;
             in_threshold = (change_percent >= config_.threshold_min && 
                            change_percent <= config_.threshold_max);
+            buffer->window_min.store(min_price, std::memory_order_relaxed);
+            buffer->window_max.store(max_price, std::memory_order_relaxed);
+            buffer->window_open.store(open_price, std::memory_order_relaxed);
         }
     }
     
@@ -91,9 +189,16 @@ void StockMonitor::process_trade(const TradeData& trade) {
             trade.volume,
             static_cast<uint64_t>(duration_cast<milliseconds>(
                 system_clock::now().time_since_epoch()).count()),
-            generate_webull_link(trade.symbol, trade.exchange)
+            generate_webull_link(trade.symbol, trade.exchange),
+            MarketContext{}
         };
         
+        if (auto cross_section = get_cross_section()) {
+            alert.context = CrossSectionCalculator::context_for(
+                *cross_section, sector_map_, change_percent,
+                buffer->sector_id, buffer->index_id);
+        }
+        
         {
             std::unique_lock threshold_lock(threshold_mutex_);
             auto it = threshold_stocks_.find(trade.symbol);
@@ -106,6 +211,10 @@ void StockMonitor::process_trade(const TradeData& trade) {
             
             if (is_new || significant_change) {
                 threshold_stocks_[trade.symbol] = alert;
+                journal_alert(is_new ? JournalEvent::Enter : JournalEvent::Update, alert);
+                FlightRecorder::record(TraceEventType::AlertEmitted, buffer->trace_id,
+                                       FlightRecorder::now(), 0,
+                                       static_cast<uint64_t>(std::llround(change_percent * 100.0)));
                 
                 // Trigger callback
                 if (alert_callback_) {
@@ -116,7 +225,20 @@ void StockMonitor::process_trade(const TradeData& trade) {
     } else {
         // Remove from threshold if no longer in range
         std::unique_lock threshold_lock(threshold_mutex_);
-        threshold_stocks_.erase(trade.symbol);
+        auto it = threshold_stocks_.find(trade.symbol);
+        if (it != threshold_stocks_.end()) {
+            AlertData& last = it->second;
+            if (analyzed) {
+                last.change_percent = change_percent;
+                last.current_price = current_price;
+                last.min_price = min_price;
+                last.max_price = max_price;
+            }
+            last.timestamp = duration_cast<milliseconds>(
+                system_clock::now().time_since_epoch()).count();
+            journal_alert(JournalEvent::Exit, last);
+            threshold_stocks_.erase(it);
+        }
     }
     
     // Update metrics
@@ -126,25 +248,44 @@ void StockMonitor::process_trade(const TradeData& trade) {
     total_updates_.fetch_add(1, std::memory_order_relaxed);
     total_processing_time_ns_.fetch_add(processing_time, std::memory_order_relaxed);
     updates_last_second_.fetch_add(1, std::memory_order_relaxed);
+    
+    // Measured from submit, so a latency spike from queueing trips it too
+    if (config_.trace_trigger_us > 0) {
+        uint64_t latency_ns = duration_cast<nanoseconds>(
+            steady_clock::now().time_since_epoch()).count() - arrival.steady_ns;
+        if (latency_ns > config_.trace_trigger_us * 1000) {
+            FlightRecorder::trigger(DumpReason::Latency);
+        }
+    }
 }
 
 void StockMonitor::process_quote(const QuoteData& quote) {
     // Convert quote to trade using mid-price
+    double mid = (quote.bid_price + quote.ask_price) / 2.0;
     TradeData trade{
         quote.symbol,
-        (quote.bid_price + quote.ask_price) / 2.0,
+        mid,
         quote.bid_size + quote.ask_size,
         quote.timestamp,
         quote.exchange
     };
-    process_trade(trade);
+    double spread_percent = mid > 0.0 ? 
+        ((quote.ask_price - quote.bid_price) / mid) * 100.0 : 0.0;
+    spread_percent = std::max(spread_percent, 0.0);
+    
+    if (ingest_) {
+        ingest_->submit(trade, spread_percent);
+    } else {
+        process_update(trade, spread_percent, IngestPipeline::Arrival::now());
+    }
 }
 
 bool StockMonitor::analyze_buffer_simd(const StockBuffer& buffer,
                                        double& change_percent,
                                        double& min_price,
                                        double& max_price,
-                                       double& current_price) const {
+                                       double& current_price,
+                                       double& open_price) const {
     auto data = buffer.buffer.get_recent(120); // Last 2 minutes
     if (data.size() < 10) return false;
     
@@ -165,6 +306,7 @@ bool StockMonitor::analyze_buffer_simd(const StockBuffer& buffer,
     if (prices.size() < 5) return false;
     
     current_price = prices.back();
+    open_price = prices.front();
     
     // Use SIMD to find min/max
     PriceCalculator::calculate_min_max_avx2(
@@ -234,28 +376,297 @@ void StockMonitor::cleanup_inactive_stocks() {
     }
     
     if (!to_remove.empty()) {
-        std::unique_lock write_lock(stocks_mutex_);
-        for (const auto& symbol : to_remove) {
-            stock_buffers_.erase(symbol);
+        evict_stocks(to_remove, now);
+    }
+}
+
+void StockMonitor::evict_stocks(const std::vector<std::string>& symbols, uint64_t now) {
+    std::unique_lock write_lock(stocks_mutex_);
+    for (const auto& symbol : symbols) {
+        auto it = stock_buffers_.find(symbol);
+        if (it == stock_buffers_.end()) continue;
+        
+        // Tick history outlives the live window: park the buffer with
+        // its window emptied until the symbol trades again
+        StockBuffer& buffer = *it->second;
+        std::unique_lock buffer_lock(buffer.mutex);
+        if (buffer.history && buffer.history->tick_count() > 0) {
+            buffer.buffer.clear();
+            buffer.last_price = 0.0;
+            buffer.window_min = 0.0;
+            buffer.window_max = 0.0;
+            buffer.window_open = 0.0;
+            buffer.spread_percent = -1.0;
+            buffer.session_volume = 0;
+            buffer_lock.unlock();
+            idle_buffers_[symbol] = std::move(it->second);
+        }
+        stock_buffers_.erase(it);
+    }
+    
+    std::unique_lock threshold_lock(threshold_mutex_);
+    for (const auto& symbol : symbols) {
+        auto it = threshold_stocks_.find(symbol);
+        if (it != threshold_stocks_.end()) {
+            it->second.timestamp = now;
+            journal_alert(JournalEvent::Exit, it->second);
+            threshold_stocks_.erase(it);
         }
+    }
+}
+
+void StockMonitor::snapshot_columns(CrossSectionColumns& columns) const {
+    columns.clear();
+    
+    std::shared_lock read_lock(stocks_mutex_);
+    columns.reserve(stock_buffers_.size());
+    
+    for (const auto& [symbol, buffer] : stock_buffers_) {
+        double min_price = buffer->window_min.load(std::memory_order_relaxed);
+        if (min_price <= 0.0) continue;  // Not analyzed yet
         
-        std::unique_lock threshold_lock(threshold_mutex_);
-        for (const auto& symbol : to_remove) {
-            threshold_stocks_.erase(symbol);
+        columns.current.push_back(buffer->last_price.load(std::memory_order_relaxed));
+        columns.min.push_back(min_price);
+        columns.max.push_back(buffer->window_max.load(std::memory_order_relaxed));
+        columns.open.push_back(buffer->window_open.load(std::memory_order_relaxed));
+        columns.sector_id.push_back(buffer->sector_id);
+        columns.index_id.push_back(buffer->index_id);
+    }
+}
+
+void StockMonitor::run_cross_section() {
+    CrossSectionColumns columns;
+    auto next_run = steady_clock::now();
+    
+    while (running_) {
+        next_run += milliseconds(config_.cross_section_interval_ms);
+        std::this_thread::sleep_until(next_run);
+        
+        snapshot_columns(columns);
+        auto result = std::make_shared<CrossSectionResult>();
+        CrossSectionCalculator::compute(columns, sector_map_, *result);
+        
+        std::unique_lock lock(cross_section_mutex_);
+        cross_section_ = std::move(result);
+    }
+}
+
+std::shared_ptr<const CrossSectionResult> StockMonitor::get_cross_section() const {
+    std::shared_lock lock(cross_section_mutex_);
+    return cross_section_;
+}
+
+void StockMonitor::snapshot_screener(ScreenerSnapshot& snapshot,
+                                     std::vector<int32_t>& sector_ids) const {
+    std::shared_lock read_lock(stocks_mutex_);
+    size_t n = stock_buffers_.size();
+    
+    sector_ids.clear();
+    sector_ids.reserve(n);
+    snapshot.symbols.reserve(n);
+    for (auto& column : snapshot.columns) {
+        column.reserve(n);
+    }
+    
+    auto& price = snapshot.column(ScreenField::Price);
+    auto& volume = snapshot.column(ScreenField::Volume);
+    auto& spread = snapshot.column(ScreenField::Spread);
+    auto& min = snapshot.column(ScreenField::Min);
+    auto& max = snapshot.column(ScreenField::Max);
+    
+    for (const auto& [symbol, buffer] : stock_buffers_) {
+        double current = buffer->last_price.load(std::memory_order_relaxed);
+        if (current <= 0.0) continue;  // No price yet (or a zero quote)
+        double window_min = buffer->window_min.load(std::memory_order_relaxed);
+        
+        snapshot.symbols.push_back(symbol);
+        sector_ids.push_back(buffer->sector_id);
+        price.push_back(current);
+        volume.push_back(static_cast<double>(
+            buffer->session_volume.load(std::memory_order_relaxed)));
+        spread.push_back(buffer->spread_percent.load(std::memory_order_relaxed));
+        // Unanalyzed symbols get min = max = price, i.e. 0% change
+        min.push_back(window_min > 0.0 ? window_min : current);
+        max.push_back(window_min > 0.0 ? 
+            buffer->window_max.load(std::memory_order_relaxed) : current);
+    }
+}
+
+void StockMonitor::run_screener_refresh() {
+    auto next_run = steady_clock::now();
+    std::vector<int32_t> sector_ids;
+    
+    while (running_) {
+        next_run += milliseconds(config_.screener_refresh_ms);
+        std::this_thread::sleep_until(next_run);
+        
+        auto snapshot = std::make_shared<ScreenerSnapshot>();
+        snapshot_screener(*snapshot, sector_ids);
+        PriceCalculator::batch_calculate_changes(
+            snapshot->column(ScreenField::Price),
+            snapshot->column(ScreenField::Min),
+            snapshot->column(ScreenField::Change));
+        
+        // Live changes against the last cross-section pass's sector moments
+        const auto& change = snapshot->column(ScreenField::Change);
+        auto& zscore = snapshot->column(ScreenField::ZScore);
+        zscore.assign(change.size(), 0.0);
+        auto cross_section = get_cross_section();
+        if (cross_section && !cross_section->zscore_means.empty()) {
+            PriceCalculator::grouped_zscores_avx2(
+                change.data(), sector_ids.data(), change.size(),
+                cross_section->zscore_means.data(),
+                cross_section->zscore_inv_stddevs.data(),
+                zscore.data());
         }
+        snapshot->timestamp = duration_cast<milliseconds>(
+            system_clock::now().time_since_epoch()).count();
+        
+        screener_.publish(std::move(snapshot));
+    }
+}
+
+ScreenResult StockMonitor::screen(const ScreenQuery& query) const {
+    return screener_.run(query);
+}
+
+void StockMonitor::journal_alert(JournalEvent event, const AlertData& alert) const {
+    if (!journal_) return;
+    
+    JournalRecord record{};
+    record.timestamp = alert.timestamp;
+    // record is zeroed, so shorter symbols stay NUL-padded
+    std::memcpy(record.symbol, alert.symbol.data(),
+                std::min(alert.symbol.size(), sizeof(record.symbol)));
+    record.event = event;
+    record.change_percent = alert.change_percent;
+    record.current_price = alert.current_price;
+    record.min_price = alert.min_price;
+    record.max_price = alert.max_price;
+    record.volume = alert.volume;
+    journal_->record(record);
+}
+
+std::vector<JournalRecord> StockMonitor::query_journal(uint64_t from_ms,
+                                                       uint64_t to_ms,
+                                                       const std::string& symbol,
+                                                       size_t limit) const {
+    if (!journal_) return {};
+    return journal_->query(from_ms, to_ms, symbol, limit);
+}
+
+std::shared_ptr<const StockMonitor::StockBuffer> StockMonitor::find_buffer(
+    const std::string& symbol) const {
+    std::shared_lock lock(stocks_mutex_);
+    auto it = stock_buffers_.find(symbol);
+    if (it != stock_buffers_.end()) return it->second;
+    auto idle = idle_buffers_.find(symbol);
+    return idle != idle_buffers_.end() ? idle->second : nullptr;
+}
+
+std::optional<TickHistory::Summary> StockMonitor::get_history_summary(const std::string& symbol,
+                                                                      uint64_t from_ms,
+                                                                      uint64_t to_ms) const {
+    auto buffer = find_buffer(symbol);
+    if (!buffer) return std::nullopt;
+    
+    std::shared_lock lock(buffer->mutex);
+    if (!buffer->history) return std::nullopt;
+    return buffer->history->summarize(from_ms, to_ms);
+}
+
+std::vector<PricePoint> StockMonitor::get_history(const std::string& symbol,
+                                                  uint64_t from_ms,
+                                                  uint64_t to_ms) const {
+    std::vector<PricePoint> points;
+    auto buffer = find_buffer(symbol);
+    if (!buffer) return points;
+    
+    std::shared_lock lock(buffer->mutex);
+    if (buffer->history) {
+        buffer->history->decode(from_ms, to_ms, points);
     }
+    return points;
+}
+
+bool StockMonitor::is_in_threshold(const std::string& symbol) const {
+    std::shared_lock lock(threshold_mutex_);
+    return threshold_stocks_.count(symbol) > 0;
+}
+
+double StockMonitor::entry_price(const std::string& symbol) const {
+    // Symbols in the band keep every update so their exit is seen
+    if (is_in_threshold(symbol)) return 0.0;
+    
+    auto buffer = find_buffer(symbol);
+    if (!buffer) return 0.0;
+    double window_min = buffer->window_min.load(std::memory_order_relaxed);
+    if (window_min <= 0.0) return 0.0;  // Not analyzed yet
+    
+    // change_percent is measured from the window low
+    return window_min * (1.0 + config_.threshold_min / 100.0);
 }
 
 void StockMonitor::set_alert_callback(AlertCallback callback) {
     alert_callback_ = std::move(callback);
 }
 
+void StockMonitor::set_subscription_callback(SubscriptionCallback callback) {
+    std::lock_guard lock(subscription_mutex_);
+    subscription_callback_ = std::move(callback);
+}
+
+void StockMonitor::subscribe(const std::vector<std::string>& symbols) {
+    std::lock_guard lock(subscription_mutex_);
+    if (!subscription_callback_) {
+        throw std::runtime_error("No feed attached");
+    }
+    subscription_callback_(symbols, true);
+    
+    std::unique_lock write_lock(stocks_mutex_);
+    for (const auto& symbol : symbols) {
+        unsubscribed_.erase(symbol);
+    }
+}
+
+void StockMonitor::unsubscribe(const std::vector<std::string>& symbols) {
+    std::lock_guard lock(subscription_mutex_);
+    if (!subscription_callback_) {
+        throw std::runtime_error("No feed attached");
+    }
+    subscription_callback_(symbols, false);
+    
+    // The symbol now belongs to another instance (or none): drop it from
+    // stats, screens and the cross-section rather than let it go stale
+    {
+        std::unique_lock write_lock(stocks_mutex_);
+        unsubscribed_.insert(symbols.begin(), symbols.end());
+    }
+    evict_stocks(symbols, duration_cast<milliseconds>(
+        system_clock::now().time_since_epoch()).count());
+}
+
 StockMonitor::Stats StockMonitor::get_stats() const {
     Stats stats;
     
+    stats.history_ticks = 0;
+    stats.history_bytes = 0;
+    size_t idle_stocks = 0;
     {
         std::shared_lock lock(stocks_mutex_);
         stats.total_stocks = stock_buffers_.size();
+        idle_stocks = idle_buffers_.size();
+        
+        if (config_.history_enabled) {
+            for (const auto* buffers : {&stock_buffers_, &idle_buffers_}) {
+                for (const auto& [symbol, buffer] : *buffers) {
+                    std::shared_lock buffer_lock(buffer->mutex);
+                    if (!buffer->history) continue;
+                    stats.history_ticks += buffer->history->tick_count();
+                    stats.history_bytes += buffer->history->memory_bytes();
+                }
+            }
+        }
     }
     
     {
@@ -271,12 +682,75 @@ StockMonitor::Stats StockMonitor::get_stats() const {
         (total_time / total_updates) / 1000.0 : 0.0;
     
     // Estimate memory usage
-    stats.memory_usage_bytes = stats.total_stocks * 
-        (sizeof(StockBuffer) + config_.buffer_size * sizeof(PricePoint));
+    stats.memory_usage_bytes = (stats.total_stocks + idle_stocks) * 
+        (sizeof(StockBuffer) + config_.buffer_size * sizeof(PricePoint)) +
+        stats.history_bytes;
+    
+    stats.advancing_pct = 0.0;
+    stats.avg_change = 0.0;
+    stats.cross_section_time_us = 0.0;
+    if (auto cross_section = get_cross_section()) {
+        stats.advancing_pct = cross_section->advancing_pct;
+        stats.avg_change = cross_section->avg_change;
+        stats.cross_section_time_us = cross_section->compute_time_ns / 1000.0;
+        stats.sectors = cross_section->sectors;
+    }
+    
+    stats.conflated_updates = 0;
+    stats.shed_updates = 0;
+    stats.queue_depth = 0;
+    stats.ingest_lag_us = 0.0;
+    stats.max_ingest_lag_us = 0.0;
+    stats.overloaded = false;
+    if (ingest_) {
+        auto ingest_stats = ingest_->get_stats();
+        stats.conflated_updates = ingest_stats.conflated;
+        stats.shed_updates = ingest_stats.shed;
+        stats.queue_depth = ingest_stats.queue_depth;
+        stats.ingest_lag_us = ingest_stats.lag_us;
+        stats.max_ingest_lag_us = ingest_stats.max_lag_us;
+        stats.overloaded = ingest_stats.overloaded;
+    }
     
     return stats;
 }
 
+void to_json(nlohmann::json& j, const StockMonitor::AlertData& alert) {
+    j = nlohmann::json{
+        {"symbol", alert.symbol},
+        {"change_percent", alert.change_percent},
+        {"current_price", alert.current_price},
+        {"min_price", alert.min_price},
+        {"max_price", alert.max_price},
+        {"volume", alert.volume},
+        {"timestamp", alert.timestamp},
+        {"webull_url", alert.webull_url},
+        {"context", alert.context}
+    };
+}
+
+void to_json(nlohmann::json& j, const StockMonitor::Stats& stats) {
+    j = nlohmann::json{
+        {"total_stocks", stats.total_stocks},
+        {"threshold_stocks", stats.threshold_stocks},
+        {"updates_per_second", stats.updates_per_second},
+        {"avg_processing_time_us", stats.avg_processing_time_us},
+        {"memory_usage_bytes", stats.memory_usage_bytes},
+        {"history_ticks", stats.history_ticks},
+        {"history_bytes", stats.history_bytes},
+        {"advancing_pct", stats.advancing_pct},
+        {"avg_change", stats.avg_change},
+        {"cross_section_time_us", stats.cross_section_time_us},
+        {"sectors", stats.sectors},
+        {"conflated_updates", stats.conflated_updates},
+        {"shed_updates", stats.shed_updates},
+        {"queue_depth", stats.queue_depth},
+        {"ingest_lag_us", stats.ingest_lag_us},
+        {"max_ingest_lag_us", stats.max_ingest_lag_us},
+        {"overloaded", stats.overloaded}
+    };
+}
+
 // SIMD implementation for min/max calculation
 void PriceCalculator::calculate_min_max_avx2(const double* prices,
                                              size_t count,
@@ -339,4 +813,116 @@ void PriceCalculator::batch_calculate_changes(const std::vector<double>& current
     }
 }
 
+size_t PriceCalculator::count_greater_avx2(const double* a, const double* b, size_t count) {
+    size_t result = 0;
+    size_t i = 0;
+    
+    for (; i + 3 < count; i += 4) {
+        __m256d va = _mm256_loadu_pd(&a[i]);
+        __m256d vb = _mm256_loadu_pd(&b[i]);
+        int mask = _mm256_movemask_pd(_mm256_cmp_pd(va, vb, _CMP_GT_OQ));
+        result += __builtin_popcount(mask);
+    }
+    
+    for (; i < count; ++i) {
+        result += a[i] > b[i] ? 1 : 0;
+    }
+    
+    return result;
+}
+
+void PriceCalculator::sum_and_squares_avx2(const double* values,
+                                           size_t count,
+                                           double& sum_out,
+                                           double& sum_sq_out) {
+    __m256d sum_vec = _mm256_setzero_pd();
+    __m256d sq_vec = _mm256_setzero_pd();
+    
+    size_t i = 0;
+    for (; i + 3 < count; i += 4) {
+        __m256d v = _mm256_loadu_pd(&values[i]);
+        sum_vec = _mm256_add_pd(sum_vec, v);
+        sq_vec = _mm256_fmadd_pd(v, v, sq_vec);
+    }
+    
+    alignas(32) double sum_arr[4], sq_arr[4];
+    _mm256_store_pd(sum_arr, sum_vec);
+    _mm256_store_pd(sq_arr, sq_vec);
+    
+    sum_out = sum_arr[0] + sum_arr[1] + sum_arr[2] + sum_arr[3];
+    sum_sq_out = sq_arr[0] + sq_arr[1] + sq_arr[2] + sq_arr[3];
+    
+    for (; i < count; ++i) {
+        sum_out += values[i];
+        sum_sq_out += values[i] * values[i];
+    }
+}
+
+void PriceCalculator::grouped_zscores_avx2(const double* values,
+                                           const int32_t* groups,
+                                           size_t count,
+                                           const double* means,
+                                           const double* inv_stddevs,
+                                           double* out) {
+    const __m128i one = _mm_set1_epi32(1);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d all_lanes = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    
+    size_t i = 0;
+    for (; i + 3 < count; i += 4) {
+        __m128i slot = _mm_add_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(&groups[i])), one);
+        // Masked form with a defined source; the plain gather leaves it undefined
+        __m256d mean = _mm256_mask_i32gather_pd(zero, means, slot, all_lanes, 8);
+        __m256d inv_std = _mm256_mask_i32gather_pd(zero, inv_stddevs, slot, all_lanes, 8);
+        __m256d v = _mm256_loadu_pd(&values[i]);
+        _mm256_storeu_pd(&out[i], _mm256_mul_pd(_mm256_sub_pd(v, mean), inv_std));
+    }
+    
+    for (; i < count; ++i) {
+        int32_t slot = groups[i] + 1;
+        out[i] = (values[i] - means[slot]) * inv_stddevs[slot];
+    }
+}
+
+size_t PriceCalculator::count_above_in_group_avx2(const double* values,
+                                                  const int32_t* groups,
+                                                  size_t count,
+                                                  int32_t group,
+                                                  double threshold) {
+    if (!groups) {
+        size_t result = 0;
+        size_t i = 0;
+        __m256d t = _mm256_set1_pd(threshold);
+        for (; i + 3 < count; i += 4) {
+            __m256d v = _mm256_loadu_pd(&values[i]);
+            result += __builtin_popcount(_mm256_movemask_pd(_mm256_cmp_pd(v, t, _CMP_GT_OQ)));
+        }
+        for (; i < count; ++i) {
+            result += values[i] > threshold ? 1 : 0;
+        }
+        return result;
+    }
+    
+    size_t result = 0;
+    size_t i = 0;
+    __m256d t = _mm256_set1_pd(threshold);
+    __m128i g = _mm_set1_epi32(group);
+    
+    for (; i + 3 < count; i += 4) {
+        // Widen the 32-bit group match to 64-bit lanes to AND with the price compare
+        __m128i match = _mm_cmpeq_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(&groups[i])), g);
+        __m256d in_group = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(match));
+        __m256d above = _mm256_cmp_pd(_mm256_loadu_pd(&values[i]), t, _CMP_GT_OQ);
+        result += __builtin_popcount(_mm256_movemask_pd(_mm256_and_pd(in_group, above)));
+    }
+    
+    for (; i < count; ++i) {
+        result += (groups[i] == group && values[i] > threshold) ? 1 : 0;
+    }
+    
+    return result;
+}
+
 } // namespace stock_monitor
\ No newline at end of file
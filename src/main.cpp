@@ -3,9 +3,16 @@
 #include <atomic>
 #include <thread>
 #include <cstdlib>
+#include <sstream>
 #include "core/StockMonitor.h"
 #include "network/AlpacaWebSocket.h"
 #include "network/ClientServer.h"
+#include "network/MockFeed.h"
+#include "cluster/HashRing.h"
+#include "utils/ThreadFactory.h"
+#include "tools/Benchmark.h"
+#include "tools/TraceConvert.h"
+#include "utils/FlightRecorder.h"
 #include <boost/program_options.hpp>
 
 namespace po = boost::program_options;
@@ -13,23 +20,79 @@ using namespace stock_monitor;
 
 std::atomic<bool> g_running{true};
 
+ThreadTopology build_thread_topology(const po::variables_map& vm) {
+    ThreadTopology topology;
+    const std::pair<const char*, ThreadRole> roles[] = {
+        {"decoder", ThreadRole::Decoder},
+        {"ingest", ThreadRole::Ingest},
+        {"dispatcher", ThreadRole::Dispatcher},
+        {"server", ThreadRole::Server},
+        {"housekeeping", ThreadRole::Housekeeping}
+    };
+    
+    std::string busy_poll = "," + vm["busy-poll"].as<std::string>() + ",";
+    
+    for (const auto& [name, role] : roles) {
+        auto& placement = topology.placement(role);
+        placement.cores = ThreadFactory::parse_cpu_list(
+            vm[std::string("cpu-") + name].as<std::string>());
+        placement.busy_poll = busy_poll.find(std::string(",") + name + ",") != std::string::npos;
+        placement.spin_iterations = vm["poll-spin"].as<uint32_t>();
+        placement.backoff_max_us = vm["poll-backoff-us"].as<uint32_t>();
+    }
+    
+    return topology;
+}
+
 void signal_handler(int signal) {
     std::cout << "\nReceived signal " << signal << ", shutting down..." << std::endl;
     g_running = false;
 }
 
+void trace_signal_handler(int) {
+    FlightRecorder::request_dump(DumpReason::Signal);
+}
+
 int main(int argc, char* argv[]) {
     // Parse command line arguments
     po::options_description desc("Stock Monitor Engine Options");
     desc.add_options()
         ("help,h", "Show help message")
-        ("key", po::value<std::string>()->required(), "Alpaca API key")
-        ("secret", po::value<std::string>()->required(), "Alpaca secret key")
+        ("benchmark", "Run offline micro-benchmarks and exit")
+        ("convert-trace", po::value<std::string>(), "Convert a flight recorder dump to Chrome trace JSON (FILE.json) and exit")
+        ("key", po::value<std::string>(), "Alpaca API key (required unless --mock-feed)")
+        ("secret", po::value<std::string>(), "Alpaca secret key (required unless --mock-feed)")
+        ("mock-feed", "Generate synthetic ticks instead of connecting to Alpaca")
+        ("mock-rate", po::value<double>()->default_value(5.0), "Mock ticks per second per symbol")
+        ("mock-seed", po::value<uint64_t>()->default_value(0), "Mock feed RNG seed (0 = random)")
+        ("symbols-file", po::value<std::string>()->default_value(""), "Universe, one symbol per line (default: built-in list)")
+        ("partition-id", po::value<std::string>()->default_value(""), "This instance's id in a partitioned deployment")
+        ("partition-members", po::value<std::string>()->default_value(""), "All instance ids, comma-separated; only this id's hash slice is subscribed")
         ("port,p", po::value<int>()->default_value(8080), "Server port")
         ("threshold-min", po::value<double>()->default_value(9.0), "Min threshold %")
         ("threshold-max", po::value<double>()->default_value(13.0), "Max threshold %")
         ("buffer-size", po::value<size_t>()->default_value(120), "Price buffer size")
-        ("max-stocks", po::value<size_t>()->default_value(10000), "Max stocks to track");
+        ("max-stocks", po::value<size_t>()->default_value(10000), "Max stocks to track")
+        ("ingest-shards", po::value<size_t>()->default_value(0), "Ingest queue shards (0 = process on feed thread)")
+        ("conflate-lag-us", po::value<uint64_t>()->default_value(2000), "Queue lag that turns on per-symbol conflation")
+        ("shed-lag-us", po::value<uint64_t>()->default_value(20000), "Queue lag that sheds symbols furthest from the threshold band")
+        ("shed-keep-pct", po::value<double>()->default_value(3.0), "When shedding, keep updates within this % below a symbol's entry price")
+        ("journal-dir", po::value<std::string>()->default_value(""), "Directory for the alert journal (empty = disabled)")
+        ("journal-retention-days", po::value<size_t>()->default_value(30), "Days of alert journal to keep")
+        ("history", "Keep compressed per-symbol tick history")
+        ("history-max-blocks", po::value<size_t>()->default_value(0), "History blocks (1 KB) kept per symbol (0 = unbounded)")
+        ("trace-dir", po::value<std::string>()->default_value("traces"), "Directory for flight recorder dumps")
+        ("trace-ring", po::value<size_t>()->default_value(65536), "Flight recorder events kept per thread (0 = disabled)")
+        ("trace-trigger-us", po::value<uint64_t>()->default_value(0), "Dump the flight recorder when an update takes longer (0 = off)")
+        ("sector-map", po::value<std::string>()->default_value(""), "CSV of symbol,sector[,index] for group aggregates")
+        ("cpu-decoder", po::value<std::string>()->default_value(""), "Cores for feed decoder threads (e.g. 2,3)")
+        ("cpu-ingest", po::value<std::string>()->default_value(""), "Cores for ingest shard threads (e.g. 4-7)")
+        ("cpu-dispatcher", po::value<std::string>()->default_value(""), "Cores for alert dispatcher threads")
+        ("cpu-server", po::value<std::string>()->default_value(""), "Cores for bridge server threads")
+        ("cpu-housekeeping", po::value<std::string>()->default_value(""), "Cores for cleanup/stats threads")
+        ("busy-poll", po::value<std::string>()->default_value(""), "Roles that busy-poll when idle (e.g. decoder,ingest)")
+        ("poll-spin", po::value<uint32_t>()->default_value(20000), "Pause-spins before a busy-poll thread backs off")
+        ("poll-backoff-us", po::value<uint32_t>()->default_value(1000), "Max idle backoff in us (0 = spin forever when busy-polling)");
     
     po::variables_map vm;
     
@@ -41,7 +104,25 @@ int main(int argc, char* argv[]) {
             return 0;
         }
         
+        // Offline; does not need API credentials
+        if (vm.count("benchmark")) {
+            return run_benchmarks(std::cout);
+        }
+        
+        if (vm.count("convert-trace")) {
+            try {
+                return convert_trace(vm["convert-trace"].as<std::string>(), std::cout);
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << std::endl;
+                return 1;
+            }
+        }
+        
         po::notify(vm);
+        
+        if (!vm.count("mock-feed") && (!vm.count("key") || !vm.count("secret"))) {
+            throw po::error("--key and --secret are required unless --mock-feed is set");
+        }
     } catch (const po::error& e) {
         std::cerr << "Error: " << e.what() << std::endl;
         std::cerr << desc << std::endl;
@@ -53,12 +134,36 @@ int main(int argc, char* argv[]) {
     std::signal(SIGTERM, signal_handler);
     
     try {
+        // Thread placement must be in place before any engine thread starts;
+        // the main thread runs the stats loop, so it is housekeeping too
+        ThreadFactory::configure(build_thread_topology(vm));
+        ThreadFactory::apply_to_current(ThreadRole::Housekeeping, "sm-main");
+        
+        FlightRecorder::Config trace_config;
+        trace_config.ring_events = vm["trace-ring"].as<size_t>();
+        trace_config.directory = vm["trace-dir"].as<std::string>();
+        FlightRecorder::configure(trace_config);
+        FlightRecorder::start();
+        
+        // Only once the recorder and its dump thread exist
+        std::signal(SIGUSR1, trace_signal_handler);
+        
         // Configure stock monitor
         StockMonitor::Config config;
         config.buffer_size = vm["buffer-size"].as<size_t>();
         config.threshold_min = vm["threshold-min"].as<double>();
         config.threshold_max = vm["threshold-max"].as<double>();
         config.max_stocks = vm["max-stocks"].as<size_t>();
+        config.sector_map_path = vm["sector-map"].as<std::string>();
+        config.journal_dir = vm["journal-dir"].as<std::string>();
+        config.journal_retention_days = vm["journal-retention-days"].as<size_t>();
+        config.history_enabled = vm.count("history") > 0;
+        config.history_max_blocks = vm["history-max-blocks"].as<size_t>();
+        config.ingest_shards = vm["ingest-shards"].as<size_t>();
+        config.conflate_lag_us = vm["conflate-lag-us"].as<uint64_t>();
+        config.shed_lag_us = vm["shed-lag-us"].as<uint64_t>();
+        config.shed_keep_pct = vm["shed-keep-pct"].as<double>();
+        config.trace_trigger_us = vm["trace-trigger-us"].as<uint64_t>();
         
         std::cout << "Starting Stock Monitor Engine" << std::endl;
         std::cout << "Configuration:" << std::endl;
@@ -74,8 +179,20 @@ int main(int argc, char* argv[]) {
         monitor->set_alert_callback([](const StockMonitor::AlertData& alert) {
             std::cout << "[ALERT] " << alert.symbol 
                      << " changed " << alert.change_percent << "%"
-                     << " (price: $" << alert.current_price << ")"
-                     << " Link: " << alert.webull_url << std::endl;
+                     << " (price: $" << alert.current_price << ")";
+            if (alert.context.index_size > 0) {
+                std::cout << " [breadth " << alert.context.advancing_pct << "% adv";
+                if (alert.context.sector_size > 0) {
+                    std::cout << ", " << alert.context.sector
+                              << " avg " << alert.context.sector_avg_change << "%"
+                              << " z " << alert.context.sector_zscore
+                              << " rank " << alert.context.sector_rank
+                              << "/" << alert.context.sector_size;
+                }
+                std::cout << ", index rank " << alert.context.index_rank
+                          << "/" << alert.context.index_size << "]";
+            }
+            std::cout << " Link: " << alert.webull_url << std::endl;
         });
         
         // Create client server for Node.js communication
@@ -84,16 +201,29 @@ int main(int argc, char* argv[]) {
         
         std::cout << "Server listening on port " << vm["port"].as<int>() << std::endl;
         
-        // Connect to Alpaca
-        AlpacaWebSocket alpaca(
-            vm["key"].as<std::string>(),
-            vm["secret"].as<std::string>(),
-            monitor.get()
-        );
+        // Connect to the feed
+        std::unique_ptr<AlpacaWebSocket> alpaca;
+        std::unique_ptr<MockFeed> mock_feed;
         
-        std::cout << "Connecting to Alpaca..." << std::endl;
-        alpaca.connect();
-        std::cout << "Connected to Alpaca data stream" << std::endl;
+        if (vm.count("mock-feed")) {
+            MockFeed::Config feed_config;
+            feed_config.ticks_per_second = vm["mock-rate"].as<double>();
+            feed_config.seed = vm["mock-seed"].as<uint64_t>();
+            mock_feed = std::make_unique<MockFeed>(monitor.get(), feed_config);
+            mock_feed->connect();
+            std::cout << "Using mock feed (" << feed_config.ticks_per_second
+                      << " ticks/s per symbol)" << std::endl;
+        } else {
+            alpaca = std::make_unique<AlpacaWebSocket>(
+                vm["key"].as<std::string>(),
+                vm["secret"].as<std::string>(),
+                monitor.get()
+            );
+            
+            std::cout << "Connecting to Alpaca..." << std::endl;
+            alpaca->connect();
+            std::cout << "Connected to Alpaca data stream" << std::endl;
+        }
         
         // Get tradeable symbols (in production, fetch from Alpaca API)
         std::vector<std::string> symbols = {
@@ -102,9 +232,44 @@ int main(int argc, char* argv[]) {
             "CRM", "ORCL", "IBM", "QCOM", "TXN", "AVGO", "MU", "AMAT"
             // In production, fetch all tradeable symbols from Alpaca
         };
+        if (!vm["symbols-file"].as<std::string>().empty()) {
+            symbols = load_symbol_list(vm["symbols-file"].as<std::string>());
+        }
+        
+        // Partitioned deployment: subscribe to our consistent-hash slice.
+        // The aggregator moves symbols later with subscribe/unsubscribe.
+        std::string partition_id = vm["partition-id"].as<std::string>();
+        if (!partition_id.empty()) {
+            HashRing ring;
+            std::stringstream members(vm["partition-members"].as<std::string>());
+            std::string member;
+            while (std::getline(members, member, ',')) {
+                if (!member.empty()) ring.add_node(member);
+            }
+            if (!ring.contains(partition_id)) {
+                throw std::invalid_argument("--partition-members must include " + partition_id);
+            }
+            
+            size_t universe = symbols.size();
+            symbols = ring.slice(partition_id, symbols);
+            std::cout << "Partition " << partition_id << ": " << symbols.size() << " of "
+                      << universe << " symbols across " << ring.nodes().size()
+                      << " instances" << std::endl;
+        }
+        
+        // Bridge subscribe/unsubscribe commands reach the feed through the
+        // monitor, which is the only handle the client server has
+        monitor->set_subscription_callback(
+            [&mock_feed, &alpaca](const std::vector<std::string>& changed, bool subscribe) {
+                if (mock_feed) {
+                    subscribe ? mock_feed->subscribe(changed) : mock_feed->unsubscribe(changed);
+                } else {
+                    subscribe ? alpaca->subscribe(changed) : alpaca->unsubscribe(changed);
+                }
+            });
         
         std::cout << "Subscribing to " << symbols.size() << " symbols..." << std::endl;
-        alpaca.subscribe(symbols);
+        monitor->subscribe(symbols);
         
         // Main loop - print stats every 10 seconds
         auto last_stats_time = std::chrono::steady_clock::now();
@@ -123,6 +288,27 @@ int main(int argc, char* argv[]) {
                 std::cout << "Avg processing time: " << stats.avg_processing_time_us << " μs" << std::endl;
                 std::cout << "Memory usage: " << (stats.memory_usage_bytes / 1024.0 / 1024.0) 
                          << " MB" << std::endl;
+                if (config.ingest_shards > 0) {
+                    std::cout << "Ingest lag: " << stats.ingest_lag_us << " μs (max "
+                             << stats.max_ingest_lag_us << " μs), queued " << stats.queue_depth
+                             << (stats.overloaded ? " [OVERLOADED]" : "") << std::endl;
+                    std::cout << "Conflated: " << stats.conflated_updates
+                             << ", shed: " << stats.shed_updates << std::endl;
+                }
+                if (config.history_enabled && stats.history_ticks > 0) {
+                    std::cout << "History: " << stats.history_ticks << " ticks in "
+                             << (stats.history_bytes / 1024.0 / 1024.0) << " MB ("
+                             << (static_cast<double>(stats.history_bytes) / stats.history_ticks)
+                             << " bytes/tick)" << std::endl;
+                }
+                std::cout << "Advancing: " << stats.advancing_pct << "%"
+                         << " (avg change " << stats.avg_change << "%, computed in "
+                         << stats.cross_section_time_us << " μs)" << std::endl;
+                for (const auto& sector : stats.sectors) {
+                    std::cout << "  " << sector.name << ": " << sector.count << " symbols, "
+                             << sector.advancing << " advancing, avg "
+                             << sector.avg_change << "%" << std::endl;
+                }
                 std::cout << "========================\n" << std::endl;
                 
                 last_stats_time = now;
@@ -132,8 +318,11 @@ int main(int argc, char* argv[]) {
         std::cout << "Shutting down..." << std::endl;
         
         // Cleanup
-        alpaca.disconnect();
+        monitor->set_subscription_callback(nullptr);
+        if (alpaca) alpaca->disconnect();
+        if (mock_feed) mock_feed->disconnect();
         server.stop();
+        FlightRecorder::stop();
         
     } catch (const std::exception& e) {
         std::cerr << "Fatal error: " << e.what() << std::endl;
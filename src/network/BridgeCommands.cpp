@@ -0,0 +1,79 @@
+#include "network/BridgeCommands.h"
+#include "core/StockMonitor.h"
+#include "utils/FlightRecorder.h"
+#include <limits>
+#include <stdexcept>
+#include <nlohmann/json.hpp>
+
+namespace stock_monitor {
+
+namespace {
+
+std::vector<std::string> symbols_of(const nlohmann::json& data) {
+    auto it = data.find("symbols");
+    if (it == data.end() || !it->is_array()) {
+        throw std::invalid_argument("symbols must be an array");
+    }
+    return it->get<std::vector<std::string>>();
+}
+
+// Bridge timestamps are ms since epoch; an absent `to` means "now"
+uint64_t time_range_end(const nlohmann::json& data) {
+    return data.value("to", std::numeric_limits<uint64_t>::max());
+}
+
+} // namespace
+
+std::optional<nlohmann::json> handle_bridge_command(StockMonitor& monitor,
+                                                    const std::string& command,
+                                                    const nlohmann::json& data) {
+    if (command == "get_active_stocks") {
+        return nlohmann::json(monitor.get_active_stocks());
+    }
+
+    if (command == "get_stats") {
+        return nlohmann::json(monitor.get_stats());
+    }
+
+    if (command == "screen") {
+        return nlohmann::json(monitor.screen(ScreenQuery::from_json(data)));
+    }
+
+    if (command == "subscribe" || command == "unsubscribe") {
+        auto symbols = symbols_of(data);
+        if (command == "subscribe") {
+            monitor.subscribe(symbols);
+        } else {
+            monitor.unsubscribe(symbols);
+        }
+        return nlohmann::json{{"symbols", symbols.size()}};
+    }
+
+    if (command == "query_journal") {
+        return nlohmann::json(monitor.query_journal(
+            data.value("from", uint64_t{0}), time_range_end(data),
+            data.value("symbol", std::string()), data.value("limit", size_t{1000})));
+    }
+
+    if (command == "get_history") {
+        auto symbol = data.at("symbol").get<std::string>();
+        uint64_t from = data.value("from", uint64_t{0});
+        uint64_t to = time_range_end(data);
+        nlohmann::json result{{"symbol", symbol}};
+        if (data.value("summary", false)) {
+            auto summary = monitor.get_history_summary(symbol, from, to);
+            result["summary"] = summary ? nlohmann::json(*summary) : nlohmann::json();
+        } else {
+            result["ticks"] = monitor.get_history(symbol, from, to);
+        }
+        return result;
+    }
+
+    if (command == "dump_trace") {
+        return nlohmann::json{{"path", FlightRecorder::dump(DumpReason::Request)}};
+    }
+
+    return std::nullopt;
+}
+
+} // namespace stock_monitor
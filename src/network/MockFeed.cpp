@@ -0,0 +1,134 @@
+#include "network/MockFeed.h"
+#include "core/StockMonitor.h"
+#include "cluster/HashRing.h"
+#include "utils/ThreadFactory.h"
+#include <chrono>
+#include <cmath>
+#include <random>
+
+namespace stock_monitor {
+
+using namespace std::chrono;
+
+namespace {
+
+constexpr auto kTickPeriod = milliseconds(10);
+
+} // namespace
+
+MockFeed::MockFeed(StockMonitor* monitor, const Config& config)
+    : monitor_(monitor), config_(config) {
+}
+
+MockFeed::~MockFeed() {
+    disconnect();
+}
+
+void MockFeed::connect() {
+    if (running_.exchange(true)) return;
+    thread_ = ThreadFactory::spawn(ThreadRole::Decoder, "sm-mockfeed", [this] { run(); });
+}
+
+void MockFeed::disconnect() {
+    running_ = false;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void MockFeed::subscribe(const std::vector<std::string>& symbols) {
+    std::lock_guard lock(mutex_);
+    for (const auto& symbol : symbols) {
+        if (index_.count(symbol)) continue;
+        index_.emplace(symbol, symbols_.size());
+        symbols_.push_back(symbol);
+        // Stable per-symbol start price in [10, 500)
+        prices_.push_back(10.0 + static_cast<double>(HashRing::hash(symbol) % 49000) / 100.0);
+    }
+}
+
+void MockFeed::unsubscribe(const std::vector<std::string>& symbols) {
+    std::lock_guard lock(mutex_);
+    for (const auto& symbol : symbols) {
+        auto it = index_.find(symbol);
+        if (it == index_.end()) continue;
+
+        // Swap-remove
+        size_t i = it->second;
+        size_t last = symbols_.size() - 1;
+        if (i != last) {
+            symbols_[i] = std::move(symbols_[last]);
+            prices_[i] = prices_[last];
+            index_[symbols_[i]] = i;
+        }
+        symbols_.pop_back();
+        prices_.pop_back();
+        index_.erase(symbol);
+    }
+}
+
+size_t MockFeed::symbol_count() const {
+    std::lock_guard lock(mutex_);
+    return symbols_.size();
+}
+
+void MockFeed::run() {
+    std::mt19937_64 rng(config_.seed ? config_.seed : std::random_device{}());
+    std::normal_distribution<double> step(0.0, 0.0005);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::geometric_distribution<int> lots(0.4);
+
+    const double period_s = duration<double>(kTickPeriod).count();
+    std::vector<TradeData> trades;
+    std::vector<QuoteData> quotes;
+    auto next = steady_clock::now();
+
+    while (running_) {
+        next += kTickPeriod;
+        trades.clear();
+        quotes.clear();
+
+        uint64_t now_ms = duration_cast<milliseconds>(
+            system_clock::now().time_since_epoch()).count();
+        {
+            std::lock_guard lock(mutex_);
+            if (!symbols_.empty()) {
+                std::poisson_distribution<size_t> arrivals(
+                    static_cast<double>(symbols_.size()) * config_.ticks_per_second * period_s);
+                std::uniform_int_distribution<size_t> pick(0, symbols_.size() - 1);
+
+                for (size_t n = arrivals(rng); n > 0; --n) {
+                    size_t i = pick(rng);
+                    double& price = prices_[i];
+                    price *= std::exp(step(rng));
+                    if (unit(rng) < config_.jump_probability) {
+                        price *= 1.11;
+                    }
+
+                    if (unit(rng) < config_.quote_ratio) {
+                        double half_spread = price * 0.0005;
+                        quotes.push_back(QuoteData{
+                            symbols_[i], price - half_spread, 100, price + half_spread, 100,
+                            now_ms, "MOCK"});
+                    } else {
+                        trades.push_back(TradeData{
+                            symbols_[i], price, static_cast<uint64_t>(100 * (lots(rng) + 1)),
+                            now_ms, "MOCK"});
+                    }
+                }
+            }
+        }
+
+        // Outside the lock so subscribe/unsubscribe never wait on analysis
+        for (const auto& trade : trades) {
+            monitor_->process_trade(trade);
+        }
+        for (const auto& quote : quotes) {
+            monitor_->process_quote(quote);
+        }
+
+        std::this_thread::sleep_until(next);
+    }
+}
+
+} // namespace stock_monitor
@@ -0,0 +1,558 @@
+#include "storage/AlertJournal.h"
+#include "utils/ThreadFactory.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <nlohmann/json.hpp>
+
+namespace stock_monitor {
+
+using namespace std::chrono;
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char kMagic[8] = {'S', 'M', 'J', 'R', 'N', 'L', '0', '1'};
+constexpr size_t kHeaderSize = 64;
+constexpr uint64_t kDayMs = 86400000;
+
+struct SegmentHeader {
+    char magic[8];
+    uint32_t day;        // YYYYMMDD (UTC)
+    uint32_t version;
+    uint64_t capacity;   // Records the file has room for
+    uint64_t count;      // Records written
+    uint8_t reserved[32];
+};
+static_assert(sizeof(SegmentHeader) == kHeaderSize, "Segment header is one cache line");
+
+uint32_t utc_day(uint64_t timestamp_ms) {
+    time_t seconds = static_cast<time_t>(timestamp_ms / 1000);
+    struct tm tm;
+    gmtime_r(&seconds, &tm);
+    return (tm.tm_year + 1900) * 10000 + (tm.tm_mon + 1) * 100 + tm.tm_mday;
+}
+
+uint64_t now_ms() {
+    return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+std::string segment_name(uint32_t day, uint32_t sequence) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "alerts-%08u-%03u.jnl", day, sequence);
+    return name;
+}
+
+std::string compacted_name(uint32_t day) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "alerts-%08u.jnl", day);
+    return name;
+}
+
+// Parses either file name form; sequence 0 marks a compacted day. The
+// whole name must match, so "alerts-YYYYMMDD.jnl.tmp" is not a segment.
+bool parse_name(const std::string& name, uint32_t& day, uint32_t& sequence) {
+    unsigned d = 0, s = 0;
+    int consumed = 0;
+    auto whole = [&](int matched, int expected) {
+        return matched == expected && static_cast<size_t>(consumed) == name.size();
+    };
+
+    if (whole(std::sscanf(name.c_str(), "alerts-%8u-%3u.jnl%n", &d, &s, &consumed), 2) && s > 0) {
+        day = d;
+        sequence = s;
+        return true;
+    }
+    consumed = 0;
+    if (whole(std::sscanf(name.c_str(), "alerts-%8u.jnl%n", &d, &consumed), 1)) {
+        day = d;
+        sequence = 0;
+        return true;
+    }
+    return false;
+}
+
+std::string symbol_of(const JournalRecord& record) {
+    return std::string(record.symbol, strnlen(record.symbol, sizeof(record.symbol)));
+}
+
+const char* event_name(JournalEvent event) {
+    switch (event) {
+        case JournalEvent::Enter:  return "enter";
+        case JournalEvent::Update: return "update";
+        case JournalEvent::Exit:   return "exit";
+    }
+    return "unknown";
+}
+
+} // namespace
+
+void to_json(nlohmann::json& j, const JournalRecord& record) {
+    j = nlohmann::json{
+        {"timestamp", record.timestamp},
+        {"symbol", symbol_of(record)},
+        {"event", event_name(record.event)},
+        {"change_percent", record.change_percent},
+        {"current_price", record.current_price},
+        {"min_price", record.min_price},
+        {"max_price", record.max_price},
+        {"volume", record.volume}
+    };
+}
+
+struct AlertJournal::Segment {
+    std::string path;
+    uint32_t day = 0;
+    uint32_t sequence = 0;
+    int fd = -1;
+    char* base = nullptr;
+    size_t mapped_bytes = 0;
+    uint64_t capacity = 0;
+    std::atomic<uint64_t> count{0};
+    bool writable = false;
+
+    SegmentHeader* header() { return reinterpret_cast<SegmentHeader*>(base); }
+    JournalRecord* records() const { return reinterpret_cast<JournalRecord*>(base + kHeaderSize); }
+
+    ~Segment() {
+        if (base) munmap(base, mapped_bytes);
+        if (fd >= 0) ::close(fd);
+    }
+
+    static std::unique_ptr<Segment> create(const std::string& path, uint32_t day,
+                                           uint32_t sequence, uint64_t capacity) {
+        auto segment = std::make_unique<Segment>();
+        segment->path = path;
+        segment->day = day;
+        segment->sequence = sequence;
+        segment->capacity = capacity;
+        segment->mapped_bytes = kHeaderSize + capacity * sizeof(JournalRecord);
+
+        segment->fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (segment->fd < 0 ||
+            ftruncate(segment->fd, static_cast<off_t>(segment->mapped_bytes)) != 0) {
+            throw std::runtime_error("Cannot create journal segment: " + path);
+        }
+
+        void* mapped = mmap(nullptr, segment->mapped_bytes, PROT_READ | PROT_WRITE,
+                            MAP_SHARED, segment->fd, 0);
+        if (mapped == MAP_FAILED) {
+            throw std::runtime_error("Cannot map journal segment: " + path);
+        }
+        segment->base = static_cast<char*>(mapped);
+        segment->writable = true;
+
+        auto* header = segment->header();
+        std::memcpy(header->magic, kMagic, sizeof(kMagic));
+        header->day = day;
+        header->version = 1;
+        header->capacity = capacity;
+        header->count = 0;
+        return segment;
+    }
+
+    // Returns null for files that are not valid segments
+    static std::unique_ptr<Segment> open(const std::string& path, uint32_t day,
+                                         uint32_t sequence) {
+        auto segment = std::make_unique<Segment>();
+        segment->path = path;
+        segment->day = day;
+        segment->sequence = sequence;
+
+        segment->fd = ::open(path.c_str(), O_RDONLY);
+        struct stat st;
+        if (segment->fd < 0 || fstat(segment->fd, &st) != 0 ||
+            static_cast<size_t>(st.st_size) < kHeaderSize) {
+            return nullptr;
+        }
+
+        segment->mapped_bytes = static_cast<size_t>(st.st_size);
+        void* mapped = mmap(nullptr, segment->mapped_bytes, PROT_READ, MAP_SHARED, segment->fd, 0);
+        if (mapped == MAP_FAILED) {
+            return nullptr;
+        }
+        segment->base = static_cast<char*>(mapped);
+
+        const auto* header = segment->header();
+        if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0) {
+            return nullptr;
+        }
+
+        // A crash can leave the header count ahead of a short file
+        uint64_t fits = (segment->mapped_bytes - kHeaderSize) / sizeof(JournalRecord);
+        segment->capacity = header->capacity;
+        segment->count = std::min(header->count, fits);
+        return segment;
+    }
+
+    // Trim the preallocated tail and remap read-only
+    void seal() {
+        if (!writable) return;
+
+        uint64_t n = count.load();
+        header()->capacity = n;
+        header()->count = n;
+        msync(base, mapped_bytes, MS_SYNC);
+        munmap(base, mapped_bytes);
+        base = nullptr;
+
+        mapped_bytes = kHeaderSize + n * sizeof(JournalRecord);
+        if (ftruncate(fd, static_cast<off_t>(mapped_bytes)) != 0) {
+            throw std::runtime_error("Cannot trim journal segment: " + path);
+        }
+        void* mapped = mmap(nullptr, mapped_bytes, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapped == MAP_FAILED) {
+            throw std::runtime_error("Cannot remap journal segment: " + path);
+        }
+        base = static_cast<char*>(mapped);
+        capacity = n;
+        writable = false;
+    }
+};
+
+AlertJournal::AlertJournal(const Config& config)
+    : config_(config) {
+    std::error_code ec;
+    fs::create_directories(config_.directory, ec);
+    if (ec) {
+        throw std::runtime_error("Cannot create journal directory: " + config_.directory);
+    }
+
+    load_segments();
+    try {
+        compact_closed_days(utc_day(now_ms()));
+    } catch (const std::exception& e) {
+        // Parts stay readable; retried at the next day change or restart
+        std::cerr << "Journal compaction failed: " << e.what() << std::endl;
+    }
+    rebuild_index();
+
+    writer_thread_ = ThreadFactory::spawn(ThreadRole::Housekeeping, "sm-journal", [this] {
+        run_writer();
+    });
+}
+
+AlertJournal::~AlertJournal() {
+    running_ = false;
+    if (writer_thread_.joinable()) {
+        writer_thread_.join();
+    }
+
+    std::unique_lock lock(mutex_);
+    close_active_segment();
+}
+
+void AlertJournal::record(const JournalRecord& record) {
+    std::lock_guard lock(pending_mutex_);
+    pending_.push_back(record);
+    pending_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AlertJournal::run_writer() {
+    std::vector<JournalRecord> batch;
+    auto idle = ThreadFactory::idle_strategy(ThreadRole::Housekeeping);
+
+    while (running_) {
+        {
+            std::lock_guard lock(pending_mutex_);
+            batch.swap(pending_);
+        }
+
+        if (batch.empty()) {
+            idle.idle();
+            continue;
+        }
+        idle.reset();
+
+        try {
+            append_batch(batch);
+        } catch (const std::exception& e) {
+            // Losing audit records beats taking the engine down
+            std::cerr << "Journal write failed, dropped " << batch.size()
+                      << " records: " << e.what() << std::endl;
+        }
+        pending_count_.fetch_sub(batch.size(), std::memory_order_relaxed);
+        batch.clear();
+    }
+
+    // Flush what arrived before shutdown
+    std::lock_guard lock(pending_mutex_);
+    if (!pending_.empty()) {
+        try {
+            append_batch(pending_);
+        } catch (const std::exception& e) {
+            std::cerr << "Journal flush failed: " << e.what() << std::endl;
+        }
+        pending_count_ = 0;
+        pending_.clear();
+    }
+}
+
+void AlertJournal::append_batch(std::vector<JournalRecord>& batch) {
+    // Producers stamp on different threads; keep the file time-ordered
+    std::stable_sort(batch.begin(), batch.end(),
+                     [](const JournalRecord& a, const JournalRecord& b) {
+                         return a.timestamp < b.timestamp;
+                     });
+
+    std::unique_lock lock(mutex_);
+
+    for (auto& record : batch) {
+        record.timestamp = std::max(record.timestamp, last_timestamp_);
+        last_timestamp_ = record.timestamp;
+
+        uint32_t day = utc_day(record.timestamp);
+        if (!active_ || active_->day != day || active_->count.load() == active_->capacity) {
+            bool day_changed = active_ && active_->day != day;
+            close_active_segment();
+            open_active_segment(day);
+            if (day_changed) {
+                try {
+                    compact_closed_days(day);
+                } catch (const std::exception& e) {
+                    std::cerr << "Journal compaction failed: " << e.what() << std::endl;
+                }
+                rebuild_index();
+            }
+        }
+
+        uint64_t index = active_->count.load(std::memory_order_relaxed);
+        active_->records()[index] = record;
+        symbol_index_[symbol_of(record)].push_back(Location{
+            static_cast<uint32_t>(segments_.size() - 1),
+            static_cast<uint32_t>(index)
+        });
+        active_->count.store(index + 1, std::memory_order_release);
+        active_->header()->count = index + 1;
+    }
+}
+
+void AlertJournal::open_active_segment(uint32_t day) {
+    uint32_t sequence = 0;
+    for (const auto& segment : segments_) {
+        if (segment->day == day) {
+            sequence = std::max(sequence, segment->sequence);
+        }
+    }
+    active_sequence_ = sequence + 1;
+
+    std::string path = (fs::path(config_.directory) / segment_name(day, active_sequence_)).string();
+    segments_.push_back(Segment::create(path, day, active_sequence_, config_.segment_records));
+    active_ = segments_.back().get();
+}
+
+void AlertJournal::close_active_segment() {
+    if (active_) {
+        active_->seal();
+        active_ = nullptr;
+    }
+}
+
+void AlertJournal::load_segments() {
+    std::vector<std::pair<std::string, std::pair<uint32_t, uint32_t>>> files;
+    for (const auto& entry : fs::directory_iterator(config_.directory)) {
+        uint32_t day, sequence;
+        std::string name = entry.path().filename().string();
+        if (!entry.is_regular_file()) continue;
+
+        // A compaction that crashed before its rename; the parts are intact
+        if (entry.path().extension() == ".tmp" && name.rfind("alerts-", 0) == 0) {
+            fs::remove(entry.path());
+            continue;
+        }
+        if (parse_name(name, day, sequence)) {
+            files.push_back({entry.path().string(), {day, sequence}});
+        }
+    }
+
+    std::sort(files.begin(), files.end(),
+              [](const auto& a, const auto& b) { return a.second < b.second; });
+
+    uint32_t compacted_day = 0;
+    for (const auto& [path, key] : files) {
+        auto [day, sequence] = key;
+
+        // Leftover parts of a day whose compaction finished renaming
+        if (sequence > 0 && day == compacted_day) {
+            fs::remove(path);
+            continue;
+        }
+
+        if (auto segment = Segment::open(path, day, sequence)) {
+            if (sequence == 0) compacted_day = day;
+            segments_.push_back(std::move(segment));
+        }
+    }
+}
+
+void AlertJournal::compact_closed_days(uint32_t current_day) {
+    uint32_t cutoff_day = utc_day(now_ms() - config_.retention_days * kDayMs);
+
+    // segments_ is only replaced once every day is done; on a throw the
+    // days not yet moved into `kept` are put back behind it
+    std::vector<std::unique_ptr<Segment>> kept;
+    size_t i = 0;
+    try {
+        while (i < segments_.size()) {
+            uint32_t day = segments_[i]->day;
+            size_t end = i;
+            while (end < segments_.size() && segments_[end]->day == day) ++end;
+
+            bool closed = day < current_day && segments_[i].get() != active_;
+            bool already_compacted = (end - i == 1 && segments_[i]->sequence == 0);
+
+            if (closed && day < cutoff_day) {
+                for (size_t k = i; k < end; ++k) {
+                    fs::remove(segments_[k]->path);
+                }
+            } else if (closed && !already_compacted) {
+                uint64_t total = 0;
+                for (size_t k = i; k < end; ++k) total += segments_[k]->count.load();
+
+                fs::path final_path = fs::path(config_.directory) / compacted_name(day);
+                std::string tmp_path = final_path.string() + ".tmp";
+
+                int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+                if (fd < 0) {
+                    throw std::runtime_error("Cannot compact journal day: " + tmp_path);
+                }
+
+                SegmentHeader header{};
+                std::memcpy(header.magic, kMagic, sizeof(kMagic));
+                header.day = day;
+                header.version = 1;
+                header.capacity = total;
+                header.count = total;
+
+                bool ok = ::write(fd, &header, sizeof(header)) == static_cast<ssize_t>(sizeof(header));
+                for (size_t k = i; k < end && ok; ++k) {
+                    size_t bytes = segments_[k]->count.load() * sizeof(JournalRecord);
+                    ok = ::write(fd, segments_[k]->records(), bytes) == static_cast<ssize_t>(bytes);
+                }
+                ok = ok && fsync(fd) == 0;
+                ::close(fd);
+                if (!ok) {
+                    fs::remove(tmp_path);
+                    throw std::runtime_error("Cannot write compacted journal day: " + tmp_path);
+                }
+
+                // Rename before removing parts; load_segments() drops leftovers
+                fs::rename(tmp_path, final_path);
+                for (size_t k = i; k < end; ++k) {
+                    if (segments_[k]->path != final_path.string()) {
+                        fs::remove(segments_[k]->path);
+                    }
+                }
+
+                if (auto segment = Segment::open(final_path.string(), day, 0)) {
+                    kept.push_back(std::move(segment));
+                }
+            } else {
+                for (size_t k = i; k < end; ++k) {
+                    kept.push_back(std::move(segments_[k]));
+                }
+            }
+
+            i = end;
+        }
+    } catch (...) {
+        for (; i < segments_.size(); ++i) {
+            if (segments_[i]) kept.push_back(std::move(segments_[i]));
+        }
+        segments_ = std::move(kept);
+        throw;
+    }
+
+    segments_ = std::move(kept);
+}
+
+void AlertJournal::rebuild_index() {
+    symbol_index_.clear();
+
+    for (size_t s = 0; s < segments_.size(); ++s) {
+        const auto& segment = *segments_[s];
+        uint64_t n = segment.count.load();
+        const JournalRecord* records = segment.records();
+
+        for (uint64_t r = 0; r < n; ++r) {
+            symbol_index_[symbol_of(records[r])].push_back(Location{
+                static_cast<uint32_t>(s), static_cast<uint32_t>(r)
+            });
+            last_timestamp_ = std::max(last_timestamp_, records[r].timestamp);
+        }
+    }
+}
+
+const JournalRecord& AlertJournal::at(Location location) const {
+    return segments_[location.segment]->records()[location.record];
+}
+
+std::vector<JournalRecord> AlertJournal::query(uint64_t from_ms,
+                                               uint64_t to_ms,
+                                               const std::string& symbol,
+                                               size_t limit) const {
+    std::vector<JournalRecord> result;
+    if (limit == 0 || from_ms > to_ms) return result;
+
+    std::shared_lock lock(mutex_);
+
+    if (!symbol.empty()) {
+        auto it = symbol_index_.find(symbol);
+        if (it == symbol_index_.end()) return result;
+
+        const auto& locations = it->second;
+        auto lo = std::lower_bound(locations.begin(), locations.end(), from_ms,
+                                   [this](Location l, uint64_t t) { return at(l).timestamp < t; });
+        auto hi = std::upper_bound(lo, locations.end(), to_ms,
+                                   [this](uint64_t t, Location l) { return t < at(l).timestamp; });
+
+        if (static_cast<size_t>(hi - lo) > limit) {
+            lo = hi - limit;
+        }
+        result.reserve(hi - lo);
+        for (auto l = lo; l != hi; ++l) {
+            result.push_back(at(*l));
+        }
+        return result;
+    }
+
+    // Walk segments newest first so `limit` keeps the most recent records
+    for (auto seg = segments_.rbegin(); seg != segments_.rend() && result.size() < limit; ++seg) {
+        const JournalRecord* begin = (*seg)->records();
+        const JournalRecord* end = begin + (*seg)->count.load(std::memory_order_acquire);
+
+        auto lo = std::lower_bound(begin, end, from_ms,
+                                   [](const JournalRecord& r, uint64_t t) { return r.timestamp < t; });
+        auto hi = std::upper_bound(lo, end, to_ms,
+                                   [](uint64_t t, const JournalRecord& r) { return t < r.timestamp; });
+
+        while (hi != lo && result.size() < limit) {
+            result.push_back(*--hi);
+        }
+    }
+
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+AlertJournal::Stats AlertJournal::get_stats() const {
+    Stats stats{0, 0, pending_count_.load(std::memory_order_relaxed)};
+
+    std::shared_lock lock(mutex_);
+    stats.segments = segments_.size();
+    for (const auto& segment : segments_) {
+        stats.records += segment->count.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+} // namespace stock_monitor
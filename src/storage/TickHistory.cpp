@@ -0,0 +1,338 @@
+#include "storage/TickHistory.h"
+#include <bit>
+#include <cstring>
+#include <algorithm>
+#include <nlohmann/json.hpp>
+
+namespace stock_monitor {
+
+namespace {
+
+// The last 8 bytes are never written so bit I/O can use whole-word loads
+constexpr uint32_t kCapacityBits = (sizeof(TickBlock::data) - 8) * 8;
+
+// Worst case per tick: 4+64 timestamp, 2+5+6+64 price, 80 volume
+constexpr uint32_t kMaxTickBits = 68 + 77 + 80;
+
+// Sentinel so the first XOR never reuses a previous bit window
+constexpr uint32_t kNoWindow = 65;
+
+uint64_t load_be64(const uint8_t* p) {
+    uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+    return __builtin_bswap64(word);
+}
+
+void store_be64(uint8_t* p, uint64_t word) {
+    word = __builtin_bswap64(word);
+    std::memcpy(p, &word, sizeof(word));
+}
+
+// ORs up to 57 bits into the zeroed stream with one word load/store
+void write_bits_short(TickBlock& block, uint64_t value, uint32_t nbits) {
+    uint32_t& pos = block.header.bit_length;
+    uint8_t* p = &block.data[pos >> 3];
+    uint32_t shift = 64 - (pos & 7) - nbits;
+    store_be64(p, load_be64(p) | (value << shift));
+    pos += nbits;
+}
+
+void write_bits(TickBlock& block, uint64_t value, uint32_t nbits) {
+    if (nbits > 57) {
+        write_bits_short(block, value >> 32, nbits - 32);
+        write_bits_short(block, value & 0xFFFFFFFFULL, 32);
+    } else {
+        write_bits_short(block, value, nbits);
+    }
+}
+
+void write_varint(TickBlock& block, uint64_t value) {
+    while (value >= 0x80) {
+        write_bits(block, (value & 0x7F) | 0x80, 8);
+        value >>= 7;
+    }
+    write_bits(block, value, 8);
+}
+
+struct BitReader {
+    const uint8_t* data;
+    uint32_t pos = 0;
+
+    // nbits in [1, 57]
+    uint64_t read_short(uint32_t nbits) {
+        uint64_t word = load_be64(&data[pos >> 3]) << (pos & 7);
+        pos += nbits;
+        return word >> (64 - nbits);
+    }
+
+    uint64_t read(uint32_t nbits) {
+        if (nbits > 57) {
+            uint64_t high = read_short(nbits - 32);
+            return (high << 32) | read_short(32);
+        }
+        return read_short(nbits);
+    }
+
+    bool bit() {
+        bool set = (data[pos >> 3] >> (7 - (pos & 7))) & 1;
+        ++pos;
+        return set;
+    }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (uint32_t shift = 0;; shift += 7) {
+            uint64_t byte = read(8);
+            value |= (byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+    }
+};
+
+uint64_t zigzag(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+int64_t unzigzag(uint64_t z) {
+    return static_cast<int64_t>(z >> 1) ^ -static_cast<int64_t>(z & 1);
+}
+
+void merge(TickHistory::Summary& summary, uint64_t ts, double price, uint64_t volume) {
+    if (summary.count == 0) {
+        summary.first_ts = ts;
+        summary.first_price = price;
+        summary.min_price = price;
+        summary.max_price = price;
+    }
+    summary.last_ts = ts;
+    summary.last_price = price;
+    summary.min_price = std::min(summary.min_price, price);
+    summary.max_price = std::max(summary.max_price, price);
+    summary.volume += volume;
+    summary.count++;
+}
+
+} // namespace
+
+TickHistory::TickHistory(size_t max_blocks)
+    : max_blocks_(max_blocks) {
+}
+
+void TickHistory::start_block(const PricePoint& point) {
+    if (max_blocks_ > 0 && blocks_.size() >= max_blocks_) {
+        tick_count_ -= blocks_.front()->header.count;
+        blocks_.pop_front();
+    }
+
+    auto block = std::make_unique<TickBlock>();
+    auto& h = block->header;
+    h.first_ts = h.last_ts = point.timestamp;
+    h.first_price = h.last_price = point.price;
+    h.min_price = h.max_price = point.price;
+    h.volume = point.volume;
+    h.count = 1;
+    h.bit_length = 0;
+    write_varint(*block, point.volume);
+
+    prev_delta_ = 0;
+    prev_price_bits_ = std::bit_cast<uint64_t>(point.price);
+    prev_leading_ = kNoWindow;
+    prev_trailing_ = 0;
+
+    blocks_.push_back(std::move(block));
+    tick_count_++;
+}
+
+void TickHistory::append(const PricePoint& in) {
+    PricePoint point = in;
+    point.timestamp = std::max(point.timestamp, last_ts_);
+    last_ts_ = point.timestamp;
+
+    if (blocks_.empty() || blocks_.back()->header.bit_length + kMaxTickBits > kCapacityBits) {
+        start_block(point);
+        return;
+    }
+
+    TickBlock& block = *blocks_.back();
+    auto& h = block.header;
+
+    // Timestamp: zigzag delta-of-delta in 1/9/15/24/68-bit buckets
+    int64_t delta = static_cast<int64_t>(point.timestamp - h.last_ts);
+    uint64_t dod = zigzag(delta - prev_delta_);
+    prev_delta_ = delta;
+
+    if (dod == 0) {
+        write_bits(block, 0b0, 1);
+    } else if (dod < (1ULL << 7)) {
+        write_bits(block, 0b10, 2);
+        write_bits(block, dod, 7);
+    } else if (dod < (1ULL << 12)) {
+        write_bits(block, 0b110, 3);
+        write_bits(block, dod, 12);
+    } else if (dod < (1ULL << 20)) {
+        write_bits(block, 0b1110, 4);
+        write_bits(block, dod, 20);
+    } else {
+        write_bits(block, 0b1111, 4);
+        write_bits(block, dod, 64);
+    }
+
+    // Price: XOR with previous, reusing the previous bit window when it fits
+    uint64_t bits = std::bit_cast<uint64_t>(point.price);
+    uint64_t x = bits ^ prev_price_bits_;
+    prev_price_bits_ = bits;
+
+    if (x == 0) {
+        write_bits(block, 0b0, 1);
+    } else {
+        uint32_t leading = std::min<uint32_t>(std::countl_zero(x), 31);
+        uint32_t trailing = std::countr_zero(x);
+
+        if (prev_leading_ != kNoWindow && leading >= prev_leading_ && trailing >= prev_trailing_) {
+            write_bits(block, 0b10, 2);
+            write_bits(block, x >> prev_trailing_, 64 - prev_leading_ - prev_trailing_);
+        } else {
+            uint32_t meaningful = 64 - leading - trailing;
+            write_bits(block, 0b11, 2);
+            write_bits(block, leading, 5);
+            write_bits(block, meaningful - 1, 6);
+            write_bits(block, x >> trailing, meaningful);
+            prev_leading_ = leading;
+            prev_trailing_ = trailing;
+        }
+    }
+
+    write_varint(block, point.volume);
+
+    h.last_ts = point.timestamp;
+    h.last_price = point.price;
+    h.min_price = std::min(h.min_price, point.price);
+    h.max_price = std::max(h.max_price, point.price);
+    h.volume += point.volume;
+    h.count++;
+    tick_count_++;
+}
+
+void TickHistory::decode_block(const TickBlock& block, std::vector<PricePoint>& out) {
+    const auto& h = block.header;
+    if (h.count == 0) return;
+
+    BitReader reader{block.data};
+    uint64_t ts = h.first_ts;
+    uint64_t price_bits = std::bit_cast<uint64_t>(h.first_price);
+    int64_t delta = 0;
+    uint32_t leading = kNoWindow;
+    uint32_t trailing = 0;
+
+    out.push_back(PricePoint{h.first_price, ts, reader.varint()});
+
+    for (uint32_t i = 1; i < h.count; ++i) {
+        uint64_t dod = 0;
+        if (reader.bit()) {
+            if (!reader.bit()) dod = reader.read(7);
+            else if (!reader.bit()) dod = reader.read(12);
+            else if (!reader.bit()) dod = reader.read(20);
+            else dod = reader.read(64);
+        }
+        delta += unzigzag(dod);
+        ts += static_cast<uint64_t>(delta);
+
+        if (reader.bit()) {
+            if (!reader.bit()) {
+                price_bits ^= reader.read(64 - leading - trailing) << trailing;
+            } else {
+                leading = static_cast<uint32_t>(reader.read(5));
+                uint32_t meaningful = static_cast<uint32_t>(reader.read(6)) + 1;
+                trailing = 64 - leading - meaningful;
+                price_bits ^= reader.read(meaningful) << trailing;
+            }
+        }
+
+        out.push_back(PricePoint{std::bit_cast<double>(price_bits), ts, reader.varint()});
+    }
+}
+
+TickHistory::Summary TickHistory::summarize(uint64_t from_ts, uint64_t to_ts) const {
+    Summary summary;
+    std::vector<PricePoint> scratch;
+
+    for (const auto& block : blocks_) {
+        const auto& h = block->header;
+        if (h.last_ts < from_ts || h.first_ts > to_ts) continue;
+
+        if (h.first_ts >= from_ts && h.last_ts <= to_ts) {
+            // Whole block in range: the header is enough
+            if (summary.count == 0) {
+                summary.first_ts = h.first_ts;
+                summary.first_price = h.first_price;
+                summary.min_price = h.min_price;
+                summary.max_price = h.max_price;
+            }
+            summary.last_ts = h.last_ts;
+            summary.last_price = h.last_price;
+            summary.min_price = std::min(summary.min_price, h.min_price);
+            summary.max_price = std::max(summary.max_price, h.max_price);
+            summary.volume += h.volume;
+            summary.count += h.count;
+            continue;
+        }
+
+        scratch.clear();
+        decode_block(*block, scratch);
+        for (const auto& point : scratch) {
+            if (point.timestamp >= from_ts && point.timestamp <= to_ts) {
+                merge(summary, point.timestamp, point.price, point.volume);
+            }
+        }
+    }
+
+    return summary;
+}
+
+void TickHistory::decode(uint64_t from_ts, uint64_t to_ts, std::vector<PricePoint>& out) const {
+    for (const auto& block : blocks_) {
+        const auto& h = block->header;
+        if (h.last_ts < from_ts || h.first_ts > to_ts) continue;
+
+        size_t start = out.size();
+        decode_block(*block, out);
+
+        if (h.first_ts < from_ts || h.last_ts > to_ts) {
+            auto outside = [from_ts, to_ts](const PricePoint& p) {
+                return p.timestamp < from_ts || p.timestamp > to_ts;
+            };
+            out.erase(std::remove_if(out.begin() + start, out.end(), outside), out.end());
+        }
+    }
+}
+
+size_t TickHistory::encoded_bits() const {
+    size_t bits = 0;
+    for (const auto& block : blocks_) {
+        bits += block->header.bit_length;
+    }
+    return bits;
+}
+
+void to_json(nlohmann::json& j, const TickHistory::Summary& summary) {
+    j = nlohmann::json{
+        {"count", summary.count},
+        {"first_ts", summary.first_ts},
+        {"last_ts", summary.last_ts},
+        {"first_price", summary.first_price},
+        {"last_price", summary.last_price},
+        {"min_price", summary.min_price},
+        {"max_price", summary.max_price},
+        {"volume", summary.volume}
+    };
+}
+
+void to_json(nlohmann::json& j, const PricePoint& point) {
+    j = nlohmann::json{
+        {"price", point.price},
+        {"timestamp", point.timestamp},
+        {"volume", point.volume}
+    };
+}
+
+} // namespace stock_monitor
@@ -0,0 +1,452 @@
+#include "tools/Benchmark.h"
+#include "core/CrossSection.h"
+#include "core/IngestPipeline.h"
+#include "core/Screener.h"
+#include "storage/TickHistory.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace stock_monitor {
+
+using namespace std::chrono;
+
+namespace {
+
+// Synthetic trading-day tape: Poisson arrivals (many ticks share a
+// millisecond), a cent-grid random walk and round-lot-heavy sizes
+std::vector<PricePoint> generate_ticks(size_t count) {
+    std::mt19937_64 rng(42);
+    std::exponential_distribution<double> gap_ms(1.0 / 20.0);
+    std::discrete_distribution<int> step({5, 20, 50, 20, 5});
+    std::geometric_distribution<int> lots(0.3);
+    std::bernoulli_distribution odd_lot(0.2);
+    std::uniform_int_distribution<int> odd_size(1, 99);
+
+    std::vector<PricePoint> ticks;
+    ticks.reserve(count);
+
+    uint64_t ts = 1700000000000ULL;
+    int64_t cents = 5000;
+    for (size_t i = 0; i < count; ++i) {
+        ts += static_cast<uint64_t>(gap_ms(rng));
+        cents = std::max<int64_t>(1, cents + step(rng) - 2);
+        uint64_t volume = odd_lot(rng) ? odd_size(rng) : 100ULL * (lots(rng) + 1);
+        ticks.push_back(PricePoint{cents / 100.0, ts, volume});
+    }
+    return ticks;
+}
+
+double seconds_since(high_resolution_clock::time_point start) {
+    return duration<double>(high_resolution_clock::now() - start).count();
+}
+
+int benchmark_tick_history(std::ostream& out) {
+    constexpr size_t kTicks = 2000000;
+    auto ticks = generate_ticks(kTicks);
+
+    TickHistory history;
+    auto start = high_resolution_clock::now();
+    for (const auto& tick : ticks) {
+        history.append(tick);
+    }
+    double encode_s = seconds_since(start);
+
+    std::vector<PricePoint> decoded;
+    decoded.reserve(kTicks);
+    start = high_resolution_clock::now();
+    history.decode(0, UINT64_MAX, decoded);
+    double decode_s = seconds_since(start);
+
+    size_t mismatches = decoded.size() == ticks.size() ? 0 : 1;
+    for (size_t i = 0; i < decoded.size() && i < ticks.size(); ++i) {
+        if (decoded[i].price != ticks[i].price ||
+            decoded[i].timestamp != ticks[i].timestamp ||
+            decoded[i].volume != ticks[i].volume) {
+            mismatches++;
+        }
+    }
+
+    // One-hour lookback in the middle of the tape
+    uint64_t from = ticks[kTicks / 2].timestamp;
+    uint64_t to = from + 3600000;
+    constexpr int kQueries = 100;
+    TickHistory::Summary summary;
+    start = high_resolution_clock::now();
+    for (int i = 0; i < kQueries; ++i) {
+        summary = history.summarize(from, to);
+    }
+    double summarize_s = seconds_since(start) / kQueries;
+
+    out << "=== Tick History ===" << std::endl;
+    out << "Ticks: " << kTicks << " in " << history.block_count() << " blocks of "
+        << sizeof(TickBlock) << " bytes" << std::endl;
+    out << "Raw PricePoint: " << sizeof(PricePoint) << " bytes/tick" << std::endl;
+    out << "Compressed: " << static_cast<double>(history.memory_bytes()) / kTicks
+        << " bytes/tick (payload " << static_cast<double>(history.encoded_bits()) / kTicks
+        << " bits/tick)" << std::endl;
+    out << "Encode: " << encode_s * 1e9 / kTicks << " ns/tick" << std::endl;
+    out << "Decode: " << kTicks / decode_s / 1e6 << " M ticks/s" << std::endl;
+    out << "1h window summary: " << summary.count << " ticks in "
+        << summarize_s * 1e6 << " μs (block headers skip interior decode)" << std::endl;
+    out << "Round-trip mismatches: " << mismatches << std::endl;
+
+    return mismatches == 0 ? 0 : 1;
+}
+
+// Synthetic market-wide snapshot: 10k symbols in 11 sectors, half of them
+// in one of 3 indexes, with windows a few percent wide
+constexpr size_t kUniverse = 10000;
+
+SectorMap make_sector_map(const std::vector<std::string>& symbols) {
+    auto path = std::filesystem::temp_directory_path() / "stock_monitor_bench_sectors.csv";
+    {
+        std::ofstream file(path);
+        for (size_t i = 0; i < symbols.size(); ++i) {
+            file << symbols[i] << ",Sector" << i % 11;
+            if (i % 2 == 0) file << ",Index" << i % 3;
+            file << "\n";
+        }
+    }
+    SectorMap map = SectorMap::load(path.string());
+    std::filesystem::remove(path);
+    return map;
+}
+
+int benchmark_cross_section(std::ostream& out) {
+    std::vector<std::string> symbols(kUniverse);
+    for (size_t i = 0; i < kUniverse; ++i) {
+        symbols[i] = "SYM" + std::to_string(i);
+    }
+    SectorMap sector_map = make_sector_map(symbols);
+
+    std::mt19937_64 rng(11);
+    std::uniform_real_distribution<double> price(1.0, 500.0);
+    std::uniform_real_distribution<double> range(0.0, 0.12);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    CrossSectionColumns columns;
+    columns.reserve(kUniverse);
+    for (size_t i = 0; i < kUniverse; ++i) {
+        double low = price(rng);
+        double high = low * (1.0 + range(rng));
+        columns.min.push_back(low);
+        columns.max.push_back(high);
+        columns.open.push_back(low + (high - low) * unit(rng));
+        columns.current.push_back(low + (high - low) * unit(rng));
+        columns.sector_id.push_back(sector_map.sector_id(symbols[i]));
+        columns.index_id.push_back(sector_map.index_id(symbols[i]));
+    }
+
+    constexpr int kPasses = 1000;
+    CrossSectionResult result;
+    auto start = high_resolution_clock::now();
+    for (int i = 0; i < kPasses; ++i) {
+        CrossSectionCalculator::compute(columns, sector_map, result);
+    }
+    double compute_s = seconds_since(start) / kPasses;
+
+    // One context per alert, against the same pass
+    constexpr size_t kContexts = 10000;
+    uint64_t rank_sum = 0;
+    start = high_resolution_clock::now();
+    for (size_t i = 0; i < kContexts; ++i) {
+        MarketContext context = CrossSectionCalculator::context_for(
+            result, sector_map, result.change[i], columns.sector_id[i], columns.index_id[i]);
+        rank_sum += context.sector_rank;
+    }
+    double context_s = seconds_since(start) / kContexts;
+
+    // Scalar reference for breadth, sector means and one symbol's ranks
+    size_t mismatches = 0;
+    size_t advancing = 0;
+    double sum = 0.0;
+    std::vector<double> sector_sum(sector_map.sector_count(), 0.0);
+    std::vector<uint32_t> sector_count(sector_map.sector_count(), 0);
+    for (size_t i = 0; i < kUniverse; ++i) {
+        double change = (columns.current[i] - columns.min[i]) / columns.min[i] * 100.0;
+        advancing += columns.current[i] > columns.open[i];
+        sum += change;
+        sector_sum[columns.sector_id[i]] += change;
+        sector_count[columns.sector_id[i]]++;
+    }
+    if (result.advancing != advancing) mismatches++;
+    if (std::abs(result.avg_change - sum / kUniverse) > 1e-9) mismatches++;
+    for (size_t s = 0; s < sector_count.size(); ++s) {
+        if (result.sectors[s].count != sector_count[s] ||
+            std::abs(result.sectors[s].avg_change - sector_sum[s] / sector_count[s]) > 1e-9) {
+            mismatches++;
+        }
+    }
+    MarketContext context = CrossSectionCalculator::context_for(
+        result, sector_map, result.change[0], columns.sector_id[0], columns.index_id[0]);
+    uint32_t above = 0;
+    for (size_t i = 0; i < kUniverse; ++i) {
+        above += columns.sector_id[i] == columns.sector_id[0] && result.change[i] > result.change[0];
+    }
+    if (context.sector_rank != above + 1) mismatches++;
+
+    out << "=== Cross Section ===" << std::endl;
+    out << "Symbols: " << kUniverse << " in " << sector_map.sector_count() << " sectors, "
+        << sector_map.index_count() << " indexes" << std::endl;
+    out << "Breadth + group aggregates + z-score moments: " << compute_s * 1e6
+        << " μs/pass" << std::endl;
+    out << "Alert context (sector/index rank): " << context_s * 1e6 << " μs/alert"
+        << " (mean sector rank " << rank_sum / kContexts << ")" << std::endl;
+    out << "Reference mismatches: " << mismatches << std::endl;
+
+    return mismatches == 0 ? 0 : 1;
+}
+
+// The README's three-predicate screen over a 10k-row mirror
+int benchmark_screen(std::ostream& out) {
+    std::mt19937_64 rng(13);
+    std::lognormal_distribution<double> price(3.0, 1.2);
+    std::lognormal_distribution<double> volume(13.0, 1.5);
+    std::uniform_real_distribution<double> range(0.0, 0.15);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::normal_distribution<double> zscore(0.0, 1.0);
+
+    auto snapshot = std::make_shared<ScreenerSnapshot>();
+    for (size_t i = 0; i < kUniverse; ++i) {
+        double low = price(rng);
+        double high = low * (1.0 + range(rng));
+        double current = low + (high - low) * unit(rng);
+        snapshot->symbols.push_back("SYM" + std::to_string(i));
+        snapshot->column(ScreenField::Price).push_back(current);
+        snapshot->column(ScreenField::Change).push_back((current - low) / low * 100.0);
+        snapshot->column(ScreenField::Volume).push_back(volume(rng));
+        snapshot->column(ScreenField::Spread).push_back(unit(rng) < 0.05 ? -1.0 : unit(rng));
+        snapshot->column(ScreenField::Min).push_back(low);
+        snapshot->column(ScreenField::Max).push_back(high);
+        snapshot->column(ScreenField::ZScore).push_back(zscore(rng));
+    }
+
+    ScreenQuery query;
+    query.predicates = {
+        {ScreenField::Price, ScreenOp::Between, 1.0, 20.0},
+        {ScreenField::Volume, ScreenOp::Greater, 1000000.0},
+        {ScreenField::Change, ScreenOp::Greater, 5.0}
+    };
+    query.limit = 50;
+
+    Screener screener;
+    screener.publish(snapshot);
+
+    constexpr int kQueries = 10000;
+    ScreenResult result;
+    auto start = high_resolution_clock::now();
+    for (int i = 0; i < kQueries; ++i) {
+        result = screener.run(query);
+    }
+    double query_s = seconds_since(start) / kQueries;
+
+    // Scalar reference: match count and the top row
+    const auto& prices = snapshot->column(ScreenField::Price);
+    const auto& volumes = snapshot->column(ScreenField::Volume);
+    const auto& changes = snapshot->column(ScreenField::Change);
+    size_t matched = 0;
+    double top_change = 0.0;
+    for (size_t i = 0; i < kUniverse; ++i) {
+        if (prices[i] >= 1.0 && prices[i] <= 20.0 && volumes[i] > 1000000.0 && changes[i] > 5.0) {
+            matched++;
+            top_change = std::max(top_change, changes[i]);
+        }
+    }
+    size_t mismatches = result.matched == matched ? 0 : 1;
+    size_t change_slot = static_cast<size_t>(ScreenField::Change);
+    if (matched > 0 && (result.rows.empty() || result.rows[0].values[change_slot] != top_change)) {
+        mismatches++;
+    }
+
+    out << "=== Screener ===" << std::endl;
+    out << "Rows: " << kUniverse << ", query: price between 1 and 20, volume > 1M, change > 5%,"
+        << " top " << query.limit << " by change" << std::endl;
+    out << "Query: " << query_s * 1e6 << " μs (" << result.matched << " matched)" << std::endl;
+    out << "Reference mismatches: " << mismatches << std::endl;
+
+    return mismatches == 0 ? 0 : 1;
+}
+
+// Open-auction burst: every symbol prints at once, far faster than the
+// sink (standing in for process_update) can keep up. A few symbols gap
+// up through the threshold band mid-burst; their alert latency is timed
+// from the submit of the first print that crosses, once with conflation
+// and shedding off and once with them on.
+struct BurstResult {
+    double seconds = 0.0;
+    IngestPipeline::Stats stats{};
+    double max_lag_us = 0.0;
+    double alert_avg_us = 0.0;
+    double alert_max_us = 0.0;
+    size_t alerts = 0;
+    size_t missed_alerts = 0;
+    size_t mismatches = 0;  // Symbols whose session low or volume differs
+};
+
+BurstResult run_ingest_burst(bool overload_handling) {
+    constexpr size_t kSymbols = 500;
+    constexpr size_t kMessages = 300000;
+    constexpr size_t kGappers = 20;
+    constexpr double kThreshold = 1.09;  // --threshold-min 9
+    constexpr auto kSinkCost = microseconds(5);
+
+    struct SymbolState {
+        double low = 0.0;  // Session low seen by the sink
+        uint64_t volume = 0;
+        bool alerted = false;
+        std::atomic<uint64_t> crossed_ns{0};  // Submit time of the raw crossing
+    };
+
+    struct RawState {
+        double price;
+        double low = 0.0;  // Of the prints so far, like the sink's
+        uint64_t volume = 0;
+        bool crossed = false;
+    };
+
+    std::vector<std::string> names(kSymbols);
+    std::unordered_map<std::string, size_t> index;
+    std::vector<RawState> raw(kSymbols);
+    for (size_t i = 0; i < kSymbols; ++i) {
+        names[i] = "SYM" + std::to_string(i);
+        index.emplace(names[i], i);
+        raw[i].price = 20.0 + static_cast<double>(i % 50);
+    }
+    auto state = std::make_unique<SymbolState[]>(kSymbols);
+
+    auto now_ns = [] {
+        return static_cast<uint64_t>(
+            duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+    };
+
+    IngestPipeline::Config config;
+    config.shards = 2;
+    if (!overload_handling) {
+        config.conflate_lag_us = UINT64_MAX / 1000;
+        config.shed_lag_us = UINT64_MAX / 1000;
+    }
+
+    // A symbol always lands on the same shard thread, which runs both the
+    // sink and the entry price lookup for it, so its state needs no lock
+    std::vector<std::vector<double>> shard_latencies_us(config.shards);
+    BurstResult result;
+    {
+        IngestPipeline pipeline(
+            config,
+            [&](const TradeData& trade, double spread_percent, const IngestPipeline::Arrival&) {
+                auto until = steady_clock::now() + kSinkCost;
+                while (steady_clock::now() < until) {
+                }
+                auto& symbol = state[index.at(trade.symbol)];
+                if (symbol.low == 0.0 || trade.price < symbol.low) symbol.low = trade.price;
+                if (spread_percent < 0.0) symbol.volume += trade.volume;
+                if (!symbol.alerted && trade.price >= symbol.low * kThreshold) {
+                    symbol.alerted = true;
+                    uint64_t crossed = symbol.crossed_ns.load(std::memory_order_acquire);
+                    if (crossed > 0) {
+                        size_t shard = std::hash<std::string>{}(trade.symbol) % config.shards;
+                        shard_latencies_us[shard].push_back((now_ns() - crossed) / 1000.0);
+                    }
+                }
+            },
+            [&](const std::string& symbol) {
+                double low = state[index.at(symbol)].low;
+                return low > 0.0 ? low * kThreshold : 0.0;
+            });
+
+        std::mt19937_64 rng(7);
+        std::normal_distribution<double> step(0.0, 0.0015);
+        std::uniform_int_distribution<size_t> pick(0, kSymbols - 1);
+        std::bernoulli_distribution is_quote(0.3);
+        std::uniform_int_distribution<uint64_t> size(1, 10);
+
+        auto start = high_resolution_clock::now();
+        for (size_t n = 0; n < kMessages; ++n) {
+            size_t i = pick(rng);
+            auto& symbol = raw[i];
+            symbol.price *= 1.0 + step(rng);
+            // Gappers jump 11% a third of the way in
+            if (i < kGappers && n > kMessages / 3 && !symbol.crossed && symbol.low > 0.0) {
+                symbol.price = symbol.low * 1.11;
+            }
+            bool quote = is_quote(rng);
+            TradeData trade{names[i], symbol.price, quote ? 0 : 100 * size(rng), n, "NASDAQ"};
+
+            if (!symbol.crossed && symbol.low > 0.0 && symbol.price >= symbol.low * kThreshold) {
+                symbol.crossed = true;
+                state[i].crossed_ns.store(now_ns(), std::memory_order_release);
+            }
+            if (symbol.low == 0.0 || symbol.price < symbol.low) symbol.low = symbol.price;
+            symbol.volume += trade.volume;
+            pipeline.submit(trade, quote ? 0.05 : -1.0);
+        }
+
+        // get_stats() resets the peak lag, so keep the worst poll
+        do {
+            std::this_thread::sleep_for(milliseconds(1));
+            result.stats = pipeline.get_stats();
+            result.max_lag_us = std::max(result.max_lag_us, result.stats.max_lag_us);
+        } while (result.stats.processed + result.stats.conflated + result.stats.shed < kMessages);
+        result.seconds = seconds_since(start);
+    }
+
+    for (const auto& latencies : shard_latencies_us) {
+        for (double us : latencies) {
+            result.alert_avg_us += us;
+            result.alert_max_us = std::max(result.alert_max_us, us);
+        }
+        result.alerts += latencies.size();
+    }
+    if (result.alerts > 0) result.alert_avg_us /= result.alerts;
+
+    for (size_t i = 0; i < kSymbols; ++i) {
+        if (raw[i].crossed && !state[i].alerted) result.missed_alerts++;
+        if (state[i].volume != raw[i].volume || state[i].low != raw[i].low) result.mismatches++;
+    }
+    return result;
+}
+
+int benchmark_ingest_burst(std::ostream& out) {
+    out << "=== Ingest Burst ===" << std::endl;
+    out << "300000 updates over 500 symbols into 2 shards, 5 μs per processed update;"
+        << " 20 symbols gap up 11% mid-burst" << std::endl;
+
+    int failures = 0;
+    for (bool overload_handling : {false, true}) {
+        BurstResult r = run_ingest_burst(overload_handling);
+        out << (overload_handling ? "Conflate + shed: " : "Queue only:      ")
+            << r.seconds * 1e3 << " ms, max lag " << r.max_lag_us / 1e3 << " ms, processed "
+            << r.stats.processed << ", conflated " << r.stats.conflated << ", shed "
+            << r.stats.shed << std::endl;
+        out << "  Alert latency: avg " << r.alert_avg_us / 1e3 << " ms, max "
+            << r.alert_max_us / 1e3 << " ms over " << r.alerts << " alerts, "
+            << r.missed_alerts << " missed" << std::endl;
+        out << "  Session low/volume mismatches: " << r.mismatches << std::endl;
+        if (r.missed_alerts > 0 || r.mismatches > 0) failures++;
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+} // namespace
+
+int run_benchmarks(std::ostream& out) {
+    int status = benchmark_tick_history(out);
+    out << std::endl;
+    status |= benchmark_ingest_burst(out);
+    out << std::endl;
+    status |= benchmark_cross_section(out);
+    out << std::endl;
+    status |= benchmark_screen(out);
+    return status;
+}
+
+} // namespace stock_monitor
@@ -0,0 +1,98 @@
+#include "tools/TraceConvert.h"
+#include <fstream>
+#include <iomanip>
+#include <nlohmann/json.hpp>
+
+namespace stock_monitor {
+
+namespace {
+
+// JSON-quoted and escaped
+std::string quoted(const std::string& value) {
+    return nlohmann::json(value).dump();
+}
+
+} // namespace
+
+void write_chrome_trace(const TraceDump& dump, std::ostream& out) {
+    auto to_us = [&dump](uint64_t tsc) {
+        double cycles = static_cast<double>(static_cast<int64_t>(tsc - dump.base_tsc));
+        return cycles / dump.tsc_per_ns / 1000.0;
+    };
+    auto cycles_to_us = [&dump](uint64_t cycles) {
+        return static_cast<double>(cycles) / dump.tsc_per_ns / 1000.0;
+    };
+    auto symbol_name = [&dump](uint32_t id) -> const std::string& {
+        static const std::string unknown = "?";
+        return id < dump.symbols.size() ? dump.symbols[id] : unknown;
+    };
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"reason\":\""
+        << dump_reason_name(dump.reason) << "\",\"base_unix_ns\":" << dump.base_unix_ns
+        << ",\"tsc_per_ns\":" << dump.tsc_per_ns << "},\"traceEvents\":[\n";
+
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+        << "\"args\":{\"name\":\"stock_monitor_engine\"}}";
+
+    if (dump.trigger_tsc != 0) {
+        out << ",\n{\"name\":\"dump: " << dump_reason_name(dump.reason)
+            << "\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"ts\":"
+            << to_us(dump.trigger_tsc) << "}";
+    }
+
+    for (const auto& thread : dump.threads) {
+        std::string name = thread.name.empty() ? "tid " + std::to_string(thread.tid) : thread.name;
+        out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread.tid
+            << ",\"args\":{\"name\":" << quoted(name) << "}}";
+
+        for (const auto& event : thread.events) {
+            out << ",\n{\"name\":\"" << trace_event_name(event.type)
+                << "\",\"pid\":1,\"tid\":" << thread.tid
+                << ",\"ts\":" << to_us(event.tsc);
+
+            if (event.duration > 0) {
+                out << ",\"ph\":\"X\",\"dur\":" << cycles_to_us(event.duration);
+            } else {
+                out << ",\"ph\":\"i\",\"s\":\"t\"";
+            }
+
+            out << ",\"args\":{\"symbol\":" << quoted(symbol_name(event.symbol_id));
+            switch (event.type) {
+                case TraceEventType::TickReceived:
+                    out << ",\"volume\":" << event.arg;
+                    break;
+                case TraceEventType::AlertEmitted:
+                    out << ",\"change_bp\":" << static_cast<int64_t>(event.arg);
+                    break;
+                default:
+                    break;
+            }
+            out << "}}";
+        }
+    }
+
+    out << "\n]}\n";
+}
+
+int convert_trace(const std::string& path, std::ostream& log) {
+    TraceDump dump = FlightRecorder::load_dump(path);
+
+    std::string out_path = path + ".json";
+    std::ofstream out(out_path, std::ios::trunc);
+    if (!out) {
+        log << "Cannot create " << out_path << std::endl;
+        return 1;
+    }
+    write_chrome_trace(dump, out);
+
+    size_t events = 0;
+    for (const auto& thread : dump.threads) {
+        events += thread.events.size();
+    }
+    log << "Wrote " << events << " events from " << dump.threads.size()
+        << " threads to " << out_path << std::endl;
+    return out ? 0 : 1;
+}
+
+} // namespace stock_monitor
@@ -0,0 +1,363 @@
+#include "utils/FlightRecorder.h"
+#include "utils/ThreadFactory.h"
+#include <bit>
+#include <chrono>
+#include <ctime>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <stdexcept>
+#include <filesystem>
+#include <unordered_map>
+#include <pthread.h>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+namespace stock_monitor {
+
+using namespace std::chrono;
+
+namespace {
+
+constexpr char kDumpMagic[8] = {'S', 'M', 'T', 'R', 'A', 'C', 'E', '1'};
+
+// Poll period of the dump thread; also how much context after a trigger
+// makes it into the dump
+constexpr auto kDumpPoll = milliseconds(50);
+
+template<typename T>
+void write_pod(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void write_string(std::ofstream& out, const std::string& value) {
+    write_pod(out, static_cast<uint32_t>(value.size()));
+    out.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+template<typename T>
+T read_pod(std::ifstream& in) {
+    T value{};
+    if (!in.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+        throw std::runtime_error("Truncated trace dump");
+    }
+    return value;
+}
+
+std::string read_string(std::ifstream& in) {
+    uint32_t size = read_pod<uint32_t>(in);
+    std::string value(size, '\0');
+    if (size > 0 && !in.read(value.data(), size)) {
+        throw std::runtime_error("Truncated trace dump");
+    }
+    return value;
+}
+
+uint64_t steady_ns() {
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+uint64_t wall_ms() {
+    return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+struct FlightRecorder::State {
+    Config config;
+    uint64_t base_tsc = 0;
+    uint64_t base_steady_ns = 0;
+    uint64_t base_unix_ns = 0;
+
+    // Rings live until exit so a dump still shows threads that have ended
+    std::mutex rings_mutex;
+    std::vector<std::unique_ptr<Ring>> rings;
+
+    std::mutex symbols_mutex;
+    std::unordered_map<std::string, uint32_t> symbol_ids;
+    std::vector<std::string> symbols{""};  // Id 0 = no symbol
+
+    // Set from signal handlers: lock-free atomics only
+    std::atomic<uint8_t> pending_reason{0};
+    std::atomic<uint64_t> trigger_tsc{0};
+    std::atomic<uint64_t> last_trigger_ms{0};
+
+    std::mutex dump_mutex;
+    std::atomic<bool> running{false};
+    std::thread dumper;
+};
+
+std::atomic<bool> FlightRecorder::enabled_{false};
+
+const char* trace_event_name(TraceEventType type) {
+    switch (type) {
+        case TraceEventType::TickReceived: return "tick";
+        case TraceEventType::LockWaited:   return "lock_wait";
+        case TraceEventType::Analyzed:     return "analyze";
+        case TraceEventType::AlertEmitted: return "alert";
+    }
+    return "unknown";
+}
+
+const char* dump_reason_name(DumpReason reason) {
+    switch (reason) {
+        case DumpReason::Signal:  return "signal";
+        case DumpReason::Request: return "request";
+        case DumpReason::Latency: return "latency";
+    }
+    return "unknown";
+}
+
+FlightRecorder::State& FlightRecorder::state() {
+    static State state;
+    return state;
+}
+
+void FlightRecorder::configure(const Config& config) {
+    auto& s = state();
+    s.config = config;
+    if (s.config.ring_events > 0) {
+        s.config.ring_events = std::bit_ceil(s.config.ring_events);
+    }
+    s.base_tsc = now();
+    s.base_steady_ns = steady_ns();
+    s.base_unix_ns = duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count();
+    enabled_.store(s.config.ring_events > 0, std::memory_order_relaxed);
+}
+
+void FlightRecorder::start() {
+    auto& s = state();
+    if (!enabled() || s.running.exchange(true)) return;
+    s.dumper = ThreadFactory::spawn(ThreadRole::Housekeeping, "sm-trace", [] { run_dumper(); });
+}
+
+void FlightRecorder::stop() {
+    auto& s = state();
+    s.running = false;
+    if (s.dumper.joinable()) {
+        s.dumper.join();
+    }
+}
+
+FlightRecorder::Ring* FlightRecorder::attach() {
+    auto& s = state();
+    auto ring = std::make_unique<Ring>();
+    // Allocated and zeroed by the owning thread: first-touched on its node
+    ring->events = std::make_unique<TraceEvent[]>(s.config.ring_events);
+    ring->mask = s.config.ring_events - 1;
+
+#ifdef __linux__
+    ring->tid = static_cast<uint32_t>(syscall(SYS_gettid));
+#else
+    ring->tid = 0;
+#endif
+    char name[16] = {};
+    pthread_getname_np(pthread_self(), name, sizeof(name));
+    ring->name = name;
+
+    std::lock_guard lock(s.rings_mutex);
+    ring_ = ring.get();
+    s.rings.push_back(std::move(ring));
+    return ring_;
+}
+
+uint32_t FlightRecorder::intern_symbol(const std::string& symbol) {
+    auto& s = state();
+    std::lock_guard lock(s.symbols_mutex);
+    auto [it, inserted] = s.symbol_ids.try_emplace(symbol, static_cast<uint32_t>(s.symbols.size()));
+    if (inserted) {
+        s.symbols.push_back(symbol);
+    }
+    return it->second;
+}
+
+void FlightRecorder::request_dump(DumpReason reason) {
+    auto& s = state();
+    s.trigger_tsc.store(now(), std::memory_order_relaxed);
+    s.pending_reason.store(static_cast<uint8_t>(reason), std::memory_order_release);
+}
+
+void FlightRecorder::trigger(DumpReason reason) {
+    auto& s = state();
+    if (!enabled()) return;
+
+    uint64_t now_ms = wall_ms();
+    uint64_t last = s.last_trigger_ms.load(std::memory_order_relaxed);
+    if (now_ms - last < s.config.min_dump_interval_ms) return;
+    if (!s.last_trigger_ms.compare_exchange_strong(last, now_ms)) return;
+
+    request_dump(reason);
+}
+
+void FlightRecorder::run_dumper() {
+    auto& s = state();
+    while (s.running) {
+        std::this_thread::sleep_for(kDumpPoll);
+
+        uint8_t reason = s.pending_reason.exchange(0, std::memory_order_acquire);
+        if (reason == 0) continue;
+
+        try {
+            std::string path = dump(static_cast<DumpReason>(reason));
+            std::cout << "[TRACE] " << dump_reason_name(static_cast<DumpReason>(reason))
+                      << " dump written to " << path << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Trace dump failed: " << e.what() << std::endl;
+        }
+    }
+}
+
+std::string FlightRecorder::dump(DumpReason reason) {
+    namespace fs = std::filesystem;
+    auto& s = state();
+    if (!enabled()) {
+        throw std::runtime_error("Flight recorder is disabled");
+    }
+
+    std::lock_guard dump_lock(s.dump_mutex);
+
+    uint64_t trigger_tsc = reason == DumpReason::Request ?
+        now() : s.trigger_tsc.load(std::memory_order_relaxed);
+
+    std::vector<Ring*> rings;
+    {
+        std::lock_guard lock(s.rings_mutex);
+        for (const auto& ring : s.rings) {
+            rings.push_back(ring.get());
+        }
+    }
+
+    // Copy each ring while its owner keeps writing. A slot is only
+    // trusted if the owner cannot have started overwriting it before the
+    // copy finished, judged by re-reading head afterwards (x86 keeps the
+    // owner's slot stores ordered after its previous head store).
+    std::vector<TraceDump::Thread> threads;
+    threads.reserve(rings.size());
+    for (Ring* ring : rings) {
+        uint64_t capacity = ring->mask + 1;
+        uint64_t end = ring->head.load(std::memory_order_acquire);
+        uint64_t begin = end > capacity ? end - capacity : 0;
+
+        TraceDump::Thread thread{ring->tid, ring->name, {}};
+        thread.events.resize(end - begin);
+        for (uint64_t i = begin; i < end; ++i) {
+            std::memcpy(&thread.events[i - begin], &ring->events[i & ring->mask], sizeof(TraceEvent));
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t head_after = ring->head.load(std::memory_order_relaxed);
+        uint64_t valid_from = head_after >= capacity ? head_after - capacity + 1 : 0;
+        if (valid_from > begin) {
+            size_t torn = std::min<uint64_t>(valid_from - begin, thread.events.size());
+            thread.events.erase(thread.events.begin(), thread.events.begin() + torn);
+        }
+        threads.push_back(std::move(thread));
+    }
+
+    std::vector<std::string> symbols;
+    {
+        std::lock_guard lock(s.symbols_mutex);
+        symbols = s.symbols;
+    }
+
+    // Calibrate against the steady clock over the whole run (invariant TSC)
+    uint64_t elapsed_ns = steady_ns() - s.base_steady_ns;
+    while (elapsed_ns < 1000000) {
+        std::this_thread::sleep_for(milliseconds(1));
+        elapsed_ns = steady_ns() - s.base_steady_ns;
+    }
+    double tsc_per_ns = static_cast<double>(now() - s.base_tsc) / static_cast<double>(elapsed_ns);
+
+    fs::create_directories(s.config.directory);
+
+    std::time_t t = std::time(nullptr);
+    std::tm tm{};
+    gmtime_r(&t, &tm);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm);
+
+    std::string base = (fs::path(s.config.directory) /
+        (std::string("trace-") + stamp + "-" + dump_reason_name(reason))).string();
+    std::string path = base + ".smtr";
+    for (int n = 1; fs::exists(path); ++n) {
+        path = base + "-" + std::to_string(n) + ".smtr";
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot create trace dump " + path);
+    }
+
+    out.write(kDumpMagic, sizeof(kDumpMagic));
+    write_pod(out, static_cast<uint8_t>(reason));
+    write_pod(out, trigger_tsc);
+    write_pod(out, s.base_tsc);
+    write_pod(out, s.base_unix_ns);
+    write_pod(out, tsc_per_ns);
+
+    write_pod(out, static_cast<uint32_t>(threads.size()));
+    for (const auto& thread : threads) {
+        write_pod(out, thread.tid);
+        write_string(out, thread.name);
+        write_pod(out, static_cast<uint64_t>(thread.events.size()));
+        out.write(reinterpret_cast<const char*>(thread.events.data()),
+                  static_cast<std::streamsize>(thread.events.size() * sizeof(TraceEvent)));
+    }
+
+    write_pod(out, static_cast<uint32_t>(symbols.size()));
+    for (const auto& symbol : symbols) {
+        write_string(out, symbol);
+    }
+
+    if (!out.flush()) {
+        throw std::runtime_error("Failed writing trace dump " + path);
+    }
+    return path;
+}
+
+TraceDump FlightRecorder::load_dump(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open trace dump " + path);
+    }
+
+    char magic[sizeof(kDumpMagic)];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kDumpMagic, sizeof(magic)) != 0) {
+        throw std::runtime_error("Not a trace dump: " + path);
+    }
+
+    TraceDump dump;
+    dump.reason = static_cast<DumpReason>(read_pod<uint8_t>(in));
+    dump.trigger_tsc = read_pod<uint64_t>(in);
+    dump.base_tsc = read_pod<uint64_t>(in);
+    dump.base_unix_ns = read_pod<uint64_t>(in);
+    dump.tsc_per_ns = read_pod<double>(in);
+
+    uint32_t thread_count = read_pod<uint32_t>(in);
+    dump.threads.resize(thread_count);
+    for (auto& thread : dump.threads) {
+        thread.tid = read_pod<uint32_t>(in);
+        thread.name = read_string(in);
+        uint64_t count = read_pod<uint64_t>(in);
+        thread.events.resize(count);
+        if (count > 0 && !in.read(reinterpret_cast<char*>(thread.events.data()),
+                                  static_cast<std::streamsize>(count * sizeof(TraceEvent)))) {
+            throw std::runtime_error("Truncated trace dump");
+        }
+    }
+
+    uint32_t symbol_count = read_pod<uint32_t>(in);
+    dump.symbols.reserve(symbol_count);
+    for (uint32_t i = 0; i < symbol_count; ++i) {
+        dump.symbols.push_back(read_string(in));
+    }
+
+    return dump;
+}
+
+} // namespace stock_monitor
@@ -0,0 +1,236 @@
+#include "utils/ThreadFactory.h"
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <filesystem>
+#include <immintrin.h>
+#include <pthread.h>
+
+#ifdef __linux__
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#endif
+
+namespace stock_monitor {
+
+namespace {
+
+ThreadTopology g_topology;
+
+#ifdef __linux__
+// CPU mask the process started with; unpinned roles are reset to it so
+// they do not inherit a pinned parent's single core
+cpu_set_t g_startup_mask;
+bool g_startup_mask_valid = false;
+
+int numa_node_of_core(int core) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::path cpu_dir = "/sys/devices/system/cpu/cpu" + std::to_string(core);
+    for (const auto& entry : fs::directory_iterator(cpu_dir, ec)) {
+        auto name = entry.path().filename().string();
+        if (name.rfind("node", 0) == 0 && name.size() > 4) {
+            try {
+                return std::stoi(name.substr(4));
+            } catch (const std::exception&) {
+                return -1;
+            }
+        }
+    }
+    return -1;
+}
+
+// "0-3,8" form of a mask, for error messages
+std::string format_mask(const cpu_set_t& mask) {
+    std::string out;
+    for (int core = 0; core < CPU_SETSIZE; ++core) {
+        if (!CPU_ISSET(core, &mask)) continue;
+        int last = core;
+        while (last + 1 < CPU_SETSIZE && CPU_ISSET(last + 1, &mask)) ++last;
+        if (!out.empty()) out += ',';
+        out += std::to_string(core);
+        if (last > core) out += '-' + std::to_string(last);
+        core = last;
+    }
+    return out;
+}
+#endif
+
+} // namespace
+
+const char* thread_role_name(ThreadRole role) {
+    switch (role) {
+        case ThreadRole::Decoder:      return "decoder";
+        case ThreadRole::Ingest:       return "ingest";
+        case ThreadRole::Dispatcher:   return "dispatcher";
+        case ThreadRole::Server:       return "server";
+        case ThreadRole::Housekeeping: return "housekeeping";
+    }
+    return "unknown";
+}
+
+ThreadPlacement& ThreadTopology::placement(ThreadRole role) {
+    switch (role) {
+        case ThreadRole::Decoder:    return decoder;
+        case ThreadRole::Ingest:     return ingest;
+        case ThreadRole::Dispatcher: return dispatcher;
+        case ThreadRole::Server:     return server;
+        default:                     return housekeeping;
+    }
+}
+
+const ThreadPlacement& ThreadTopology::placement(ThreadRole role) const {
+    return const_cast<ThreadTopology*>(this)->placement(role);
+}
+
+IdleStrategy::IdleStrategy(const ThreadPlacement& placement)
+    : spin_limit_(placement.busy_poll ? placement.spin_iterations : 0)
+    , backoff_max_us_(placement.backoff_max_us) {
+    // Sleeping threads need a cap even if the config left it at zero
+    if (!placement.busy_poll && backoff_max_us_ == 0) {
+        backoff_max_us_ = 1000;
+    }
+}
+
+void IdleStrategy::idle() {
+    if (idle_count_ < spin_limit_ || backoff_max_us_ == 0) {
+        ++idle_count_;
+        _mm_pause();
+        return;
+    }
+
+    std::this_thread::sleep_for(std::chrono::microseconds(backoff_us_));
+    backoff_us_ = std::min(backoff_us_ * 2, backoff_max_us_);
+}
+
+void ThreadFactory::configure(const ThreadTopology& topology) {
+#ifdef __linux__
+    if (!g_startup_mask_valid) {
+        CPU_ZERO(&g_startup_mask);
+        g_startup_mask_valid =
+            sched_getaffinity(0, sizeof(g_startup_mask), &g_startup_mask) == 0;
+    }
+
+    // A core we may not run on would leave the role silently unpinned
+    const ThreadRole roles[] = {ThreadRole::Decoder, ThreadRole::Ingest, ThreadRole::Dispatcher,
+                                ThreadRole::Server, ThreadRole::Housekeeping};
+    for (ThreadRole role : roles) {
+        for (int core : topology.placement(role).cores) {
+            bool usable = core >= 0 && core < CPU_SETSIZE &&
+                (!g_startup_mask_valid || CPU_ISSET(core, &g_startup_mask));
+            if (!usable) {
+                throw std::invalid_argument(
+                    std::string(thread_role_name(role)) + " core " + std::to_string(core) +
+                    " is not available to this process (usable: " +
+                    (g_startup_mask_valid ? format_mask(g_startup_mask) : "unknown") + ")");
+            }
+        }
+    }
+#endif
+
+    g_topology = topology;
+}
+
+const ThreadTopology& ThreadFactory::topology() {
+    return g_topology;
+}
+
+void ThreadFactory::apply_to_current(ThreadRole role, const std::string& name, size_t index) {
+    // Kernel limit is 15 chars + NUL
+    std::string short_name = name.substr(0, 15);
+#ifdef __APPLE__
+    pthread_setname_np(short_name.c_str());
+#else
+    pthread_setname_np(pthread_self(), short_name.c_str());
+#endif
+
+#ifdef __linux__
+    const auto& placement = g_topology.placement(role);
+
+    // configure() validated the cores; failures here (e.g. a cpuset
+    // changed underneath us) are reported but do not stop the thread
+    if (!placement.cores.empty()) {
+        int core = placement.cores[index % placement.cores.size()];
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        CPU_SET(core, &mask);
+        int rc = pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask);
+        if (rc != 0) {
+            std::cerr << "[THREAD] " << short_name << ": cannot pin to core " << core
+                      << ": " << std::strerror(rc) << std::endl;
+        }
+    } else if (g_startup_mask_valid) {
+        pthread_setaffinity_np(pthread_self(), sizeof(g_startup_mask), &g_startup_mask);
+    }
+
+    int node = numa_node_of(role, index);
+    if (node >= static_cast<int>(sizeof(unsigned long) * 8)) {
+        std::cerr << "[THREAD] " << short_name << ": NUMA node " << node
+                  << " is beyond the supported range, memory policy not set" << std::endl;
+    } else if (node >= 0) {
+        unsigned long nodemask = 1UL << node;
+        if (syscall(SYS_set_mempolicy, MPOL_PREFERRED, &nodemask, sizeof(nodemask) * 8) != 0) {
+            std::cerr << "[THREAD] " << short_name << ": cannot prefer NUMA node " << node
+                      << ": " << std::strerror(errno) << std::endl;
+        }
+    }
+#else
+    (void)role;
+    (void)index;
+#endif
+}
+
+int ThreadFactory::numa_node_of(ThreadRole role, size_t index) {
+    const auto& placement = g_topology.placement(role);
+    if (placement.numa_node >= 0) {
+        return placement.numa_node;
+    }
+#ifdef __linux__
+    if (!placement.cores.empty()) {
+        return numa_node_of_core(placement.cores[index % placement.cores.size()]);
+    }
+#else
+    (void)index;
+#endif
+    return -1;
+}
+
+std::vector<int> ThreadFactory::parse_cpu_list(const std::string& spec) {
+    std::vector<int> cores;
+    size_t pos = 0;
+
+    while (pos < spec.size()) {
+        size_t comma = spec.find(',', pos);
+        std::string item = spec.substr(pos, comma == std::string::npos ? std::string::npos
+                                                                         : comma - pos);
+        pos = (comma == std::string::npos) ? spec.size() : comma + 1;
+        if (item.empty()) continue;
+
+        try {
+            size_t dash = item.find('-');
+            if (dash == std::string::npos) {
+                cores.push_back(std::stoi(item));
+            } else {
+                int first = std::stoi(item.substr(0, dash));
+                int last = std::stoi(item.substr(dash + 1));
+                if (first > last) {
+                    throw std::invalid_argument("descending range");
+                }
+                for (int core = first; core <= last; ++core) {
+                    cores.push_back(core);
+                }
+            }
+        } catch (const std::exception&) {
+            throw std::invalid_argument("Invalid CPU list: " + spec);
+        }
+    }
+
+    return cores;
+}
+
+} // namespace stock_monitor